@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+class SpawnTable;
+
+namespace bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    inline double secondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    /* Marks the run as failed; the bench exits nonzero once everything selected has run. */
+    void fail(const char* reason);
+
+    /* A file checked in next to the sources, wherever the bench is run from. */
+    std::string sourceFile(const char* name);
+
+    /* The entities of level.png, as listed in level.spawns.txt. */
+    const SpawnTable& levelSpawns();
+
+    /* Keeps the optimizer from discarding a result. */
+    template <typename T>
+    inline void consume(const T& value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    void ticks();
+    void entities();
+    void broadphase();
+    void bins();
+    void render();
+    void terrain();
+    void stream();
+    void editor();
+    void queries();
+    void replay();
+    void profiler();
+    void simthread();
+    void drs();
+    void rewind();
+    void batch();
+    void latency();
+    void allocs();
+    void save();
+    void startup();
+    void chase();
+    void regions();
+    void spawns();
+    void particles();
+}
@@ -0,0 +1,142 @@
+#include "bench.h"
+
+#include <vector>
+#include "alloctracker.h"
+#include "columnbins.h"
+#include "inputqueue.h"
+#include "profiler.h"
+#include "rewindbuffer.h"
+#include "terraincolumns.h"
+#include "worldsnapshot.h"
+
+namespace
+{
+    struct Stage
+    {
+        const char* name;
+        AllocTracker::Counts steady;
+    };
+}
+
+/*
+ * The per-frame CPU work of App and the simulation thread, minus GL, on one
+ * thread. Fails the run if any frame after warm-up touches the heap, and
+ * names the stages that did.
+ */
+void bench::allocs()
+{
+    if(!AllocTracker::Enabled)
+    {
+        printf("allocation tracking is not compiled in; configure with -DSUSJAM23_ALLOC_TRACKING=ON\n");
+        return;
+    }
+
+    static const int warmup{600};
+    static const int frames{20000};
+    static const int width{1440};
+    static const float aspect{1440.0f / 800.0f};
+
+    std::vector<unsigned char> map(4096 * GameWorld::MapStride, 0x80);
+    for(size_t i = 0; i < 4096; ++i)
+    {
+        map[i * GameWorld::MapStride + 2] = (i % 700) == 600 ? 0xFF : 0x00;
+    }
+    GameWorld world;
+    world.setMap(map.data(), 4096, 64.0f);
+    for(int i = 0; i < 200; ++i)
+    {
+        world.spawnEnemy(glm::vec2(i * 0.3f, 0.0f));
+        world.spawnCollectable(glm::vec2(i * 0.3f + 0.1f, 0.08f));
+    }
+    world.setSpawns(&bench::levelSpawns());
+
+    InputQueue inputs;
+    RewindBuffer rewind;
+    WorldSnapshot previous;
+    WorldSnapshot current;
+    WorldSnapshot blended;
+    ColumnBins bins;
+    TerrainColumns terrain;
+
+    Stage stages[] = {{"input", {}}, {"step", {}}, {"snapshot", {}}, {"rewind", {}}, {"interpolate", {}}, {"bins", {}},
+        {"terrain", {}}};
+    AllocTracker::Frames tracker{warmup};
+    for(int frame = 0; frame < frames; ++frame)
+    {
+        int stage{0};
+        AllocTracker::Counts mark = AllocTracker::thread();
+        auto next = [&]() {
+            AllocTracker::Counts now = AllocTracker::thread();
+            if(tracker.steady())
+            {
+                AllocTracker::Counts delta = now - mark;
+                stages[stage].steady.allocations += delta.allocations;
+                stages[stage].steady.bytes += delta.bytes;
+            }
+            mark = now;
+            ++stage;
+        };
+
+        // Scripted play: run right, turn back now and then, jump and shoot.
+        uint64_t time = static_cast<uint64_t>(frame) * 8333333;
+        bool right = (frame / 900) % 4 != 3;
+        inputs.push(right ? InputQueue::Button::RIGHT : InputQueue::Button::LEFT, true, time);
+        inputs.push(right ? InputQueue::Button::LEFT : InputQueue::Button::RIGHT, false, time);
+        inputs.push(InputQueue::Button::JUMP, frame % 90 < 5, time);
+        if(frame % 30 == 0)
+        {
+            inputs.push(InputQueue::Button::FIRE, true, time);
+            inputs.push(InputQueue::Button::FIRE, false, time);
+        }
+        GameWorld::Input input = inputs.take(time);
+        next();
+
+        world.step(GameWorld::FixedTimestep, input);
+        next();
+
+        std::swap(previous, current);
+        world.snapshot(current);
+        next();
+
+        rewind.push(world);
+        next();
+
+        WorldSnapshot::interpolate(previous, current, 0.5f, blended);
+        next();
+
+        bins.build(blended, aspect, width / 16);
+        next();
+
+        TerrainColumns::Input columns;
+        columns.width = width;
+        columns.aspect = aspect;
+        columns.camera = blended.camera2d.x;
+        columns.time = blended.time;
+        columns.shake = blended.shake;
+        columns.map = world.mapBytes();
+        columns.mapColumns = world.mapColumns();
+        columns.columnsPerUnit = world.columnsPerUnit();
+        terrain.build(columns);
+        next();
+
+        tracker.frame();
+    }
+
+    printf("%d frames after %d warm-up: %llu allocated, worst %llu allocations / %llu bytes in a frame\n",
+        frames - warmup, warmup, static_cast<unsigned long long>(tracker.allocatingFrames()),
+        static_cast<unsigned long long>(tracker.worst().allocations),
+        static_cast<unsigned long long>(tracker.worst().bytes));
+    for(const Stage& stage : stages)
+    {
+        if(stage.steady.allocations)
+        {
+            printf("  %-12s %8llu allocations, %10llu bytes\n", stage.name,
+                static_cast<unsigned long long>(stage.steady.allocations),
+                static_cast<unsigned long long>(stage.steady.bytes));
+        }
+    }
+    if(tracker.allocatingFrames())
+    {
+        fail("steady-state frames allocated");
+    }
+}
@@ -0,0 +1,73 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "batchrunner.h"
+
+namespace
+{
+    /* Rolling hills, with a water column every pitSpacing columns when it is nonzero. */
+    std::vector<unsigned char> makeLevel(int width, int pitSpacing)
+    {
+        std::vector<unsigned char> map(width * GameWorld::MapStride, 0x80);
+        for(int i = 0; i < width; ++i)
+        {
+            int hill = i % 256 < 128 ? i % 128 : 127 - i % 128;
+            map[i * GameWorld::MapStride] = static_cast<unsigned char>(0x80 + hill / 4);
+            map[i * GameWorld::MapStride + 2] = pitSpacing && i % pitSpacing == pitSpacing / 2 ? 0xFF : 0x00;
+        }
+        return map;
+    }
+}
+
+void bench::batch()
+{
+    static const int width{512};
+    static const float columnsPerUnit{16.0f};
+
+    BatchRunner::Config config;
+    config.instances = 256;
+    config.maxTicks = static_cast<unsigned long long>(60.0f / GameWorld::FixedTimestep);
+    config.spawns = &bench::levelSpawns();
+
+    struct Level
+    {
+        const char* name;
+        std::vector<unsigned char> map;
+    };
+    const Level levels[] = {
+        {"open", makeLevel(width, 0)},
+        {"pits", makeLevel(width, 128)},
+    };
+
+    unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<unsigned> threadCounts;
+    for(unsigned threads = 1; threads < cores; threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(cores);
+
+    for(const Level& level : levels)
+    {
+        for(BatchRunner::Bot bot : {BatchRunner::Bot::RUNNER, BatchRunner::Bot::RANDOM})
+        {
+            config.bot = bot;
+            double single{0.0};
+            for(unsigned threads : threadCounts)
+            {
+                BatchRunner runner{std::make_shared<ThreadPool>(threads)};
+                BatchRunner::Report report = runner.run(level.map.data(), width, columnsPerUnit, config);
+                single = threads == 1 ? report.ticksPerSecond() : single;
+                printf("%-4s %-6s x%2u: %3d/%d completed, %5.2f water hits, %5.2f enemy hits per run,"
+                    " %9.0f ticks/s, %8.0f per thread, %5.2fx one thread\n",
+                    level.name, bot == BatchRunner::Bot::RUNNER ? "runner" : "random", threads,
+                    report.completed, report.instances,
+                    static_cast<double>(report.waterHits) / report.instances,
+                    static_cast<double>(report.enemyHits) / report.instances,
+                    report.ticksPerSecond(), report.ticksPerSecondPerThread(), report.ticksPerSecond() / single);
+            }
+        }
+    }
+}
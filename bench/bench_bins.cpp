@@ -0,0 +1,93 @@
+#include "bench.h"
+
+#include <cmath>
+#include <vector>
+#include "columnbins.h"
+
+namespace
+{
+    bool binContains(const ColumnBins& bins, int bin, float x, float y, int type)
+    {
+        for(int i = bins.first(bin); i < bins.first(bin) + bins.count(bin); ++i)
+        {
+            const auto& item = bins.item(i);
+            if(item.x == x && item.y == y && (static_cast<int>(item.w) & 3) == type)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+     * Reference check against the world itself: every entity whose x test in
+     * the shader passes for a pixel column must be in that column's bin.
+     * Returns the number of misses.
+     */
+    int verify(const GameWorld& world, const ColumnBins& bins, float aspect, int width)
+    {
+        int misses{0};
+        for(int column = 0; column < width; ++column)
+        {
+            float stx = bins.origin() + (column + 0.5f) / width * aspect;
+            int bin = bins.binOf(stx);
+            auto check = [&](const glm::vec2& position, float radius, int type) {
+                glm::vec2 p = position + 0.5f;
+                if(std::abs(p.x - stx) < radius && !binContains(bins, bin, p.x, p.y, type))
+                {
+                    ++misses;
+                }
+            };
+            for(size_t i = 0; i < world.enemies().size(); ++i)
+            {
+                check(world.enemies().positions()[i], ColumnBins::EnemyRadius, ColumnBins::ENEMY);
+            }
+            for(size_t i = 0; i < world.collectables().size(); ++i)
+            {
+                check(world.collectables().positions()[i], ColumnBins::CollectableRadius, ColumnBins::COLLECTABLE);
+            }
+        }
+        return misses;
+    }
+}
+
+void bench::bins()
+{
+    static const int width{1440};
+    static const float aspect{1440.0f / 800.0f};
+    static const int frames{200};
+
+    for(int count : {10, 1000, 100000})
+    {
+        GameWorld world;
+        // Spread everything over a level a hundred screens wide.
+        float levelWidth = aspect * 100.0f;
+        for(int i = 0; i < count; ++i)
+        {
+            float x = levelWidth * i / count - 0.5f;
+            world.spawnEnemy(glm::vec2(x, 0.0f));
+            world.spawnCollectable(glm::vec2(x + 0.01f, 0.08f));
+        }
+
+        WorldSnapshot snapshot;
+        world.snapshot(snapshot);
+        ColumnBins bins;
+        auto start = Clock::now();
+        for(int frame = 0; frame < frames; ++frame)
+        {
+            bins.build(snapshot, aspect, width / 16);
+        }
+        double elapsed = secondsSince(start) / frames;
+
+        int items = static_cast<int>(bins.texels().size()) - bins.binCount();
+        int widest{0};
+        for(int bin = 0; bin < bins.binCount(); ++bin)
+        {
+            widest = std::max(widest, bins.count(bin));
+        }
+        int misses = count <= 1000 ? verify(world, bins, aspect, width) : 0;
+        printf("%6d enemies + %6d collectables: build %8.1f us, %5d binned items, widest bin %3d (shader used to loop %d)%s\n",
+            count, count, elapsed * 1e6, items, widest, count * 2,
+            misses ? " MISSES" : "");
+    }
+}
@@ -0,0 +1,95 @@
+#include "bench.h"
+
+#include <random>
+#include <vector>
+#include "sweepindex.h"
+
+namespace
+{
+    static const float hitRadiusSquared{0.005f};
+
+    // The loop GameWorld ran before the broad phase: first enemy in pool order.
+    int bruteForceFirst(const glm::vec2& point, const std::vector<glm::vec2>& enemies)
+    {
+        for(size_t j = 0; j < enemies.size(); ++j)
+        {
+            glm::vec2 delta = point - enemies[j];
+            if(delta.x * delta.x + delta.y * delta.y < hitRadiusSquared)
+            {
+                return static_cast<int>(j);
+            }
+        }
+        return -1;
+    }
+
+    std::vector<glm::vec2> scatter(std::mt19937& rng, size_t count, float width)
+    {
+        std::uniform_real_distribution<float> x{0.0f, width};
+        std::uniform_real_distribution<float> y{-0.1f, 0.3f};
+        std::vector<glm::vec2> points(count);
+        for(auto& p : points)
+        {
+            p = glm::vec2(x(rng), y(rng));
+        }
+        return points;
+    }
+}
+
+void bench::broadphase()
+{
+    static const int ticks{20};
+    std::mt19937 rng{23};
+
+    for(size_t enemyCount : {10, 1000, 100000})
+    {
+        for(size_t projectileCount : {10, 1000})
+        {
+            // Keep roughly ten enemies per world unit, like a busy screen.
+            float width = 4.0f + enemyCount * 0.1f;
+            std::vector<glm::vec2> enemies = scatter(rng, enemyCount, width);
+            std::vector<glm::vec2> projectiles = scatter(rng, projectileCount, width);
+            std::vector<int> expected(projectileCount);
+            std::vector<int> actual(projectileCount);
+
+            auto start = Clock::now();
+            for(int tick = 0; tick < ticks; ++tick)
+            {
+                for(size_t i = 0; i < projectileCount; ++i)
+                {
+                    expected[i] = bruteForceFirst(projectiles[i], enemies);
+                }
+            }
+            double bruteForce = secondsSince(start) / ticks;
+
+            SweepIndex index;
+            start = Clock::now();
+            for(int tick = 0; tick < ticks; ++tick)
+            {
+                index.rebuild(enemies.data(), enemies.size());
+                for(size_t i = 0; i < projectileCount; ++i)
+                {
+                    actual[i] = index.firstWithin(projectiles[i], hitRadiusSquared, enemies.data());
+                }
+            }
+            double sweep = secondsSince(start) / ticks;
+
+            int hits{0};
+            int mismatches{0};
+            for(size_t i = 0; i < projectileCount; ++i)
+            {
+                hits += expected[i] >= 0;
+                if(expected[i] != actual[i])
+                {
+                    printf("MISMATCH projectile %zu: brute force %d, sweep %d\n", i, expected[i], actual[i]);
+                    ++mismatches;
+                }
+            }
+            printf("%6zu enemies x %4zu projectiles: brute force %9.1f us, sweep %7.1f us, %4d hits\n",
+                enemyCount, projectileCount, bruteForce * 1e6, sweep * 1e6, hits);
+            if(mismatches)
+            {
+                fail("sweep hits differ from brute force");
+            }
+        }
+    }
+}
@@ -0,0 +1,167 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "flowfield.h"
+#include "gameworld.h"
+#include "random.h"
+
+namespace
+{
+    /* Rolling hills with ponds and the odd cliff, in the level.png layout. */
+    std::vector<unsigned char> hillyMap(size_t columns, Random& random)
+    {
+        std::vector<unsigned char> bytes(columns * GameWorld::MapStride, 0);
+        float cliff{0.0f};
+        for(size_t i = 0; i < columns; ++i)
+        {
+            if(random.below(2000) == 0)
+            {
+                cliff = cliff > 0.0f ? 0.0f : 0.2f;
+            }
+            float height = 0.5f + 0.15f * std::sin(i * 0.003f) + 0.05f * std::sin(i * 0.021f) + cliff;
+            bytes[i * GameWorld::MapStride + 0] = static_cast<unsigned char>(std::min(height, 1.0f) * 255.0f);
+            bytes[i * GameWorld::MapStride + 2] = (i % 5000) > 4960 ? 0xFF : 0x00;
+        }
+        return bytes;
+    }
+
+    /* What one enemy would do without the field: walk its own path to the target. */
+    int walk(const Terrain& terrain, size_t from, size_t target)
+    {
+        int direction = from < target ? 1 : from > target ? -1 : 0;
+        for(size_t c = from; c != target; c += direction)
+        {
+            if(!FlowField::passable(terrain, c, c + direction))
+            {
+                return 0;
+            }
+        }
+        return direction;
+    }
+}
+
+/*
+ * Chasers reading their direction from the shared field, from 10 to 100k of
+ * them around the player. The cost per chaser should stay flat and the field
+ * itself should not grow with the count; walking every chaser's own path is
+ * shown next to it. The target then sweeps the whole level to time moving the
+ * window.
+ */
+void bench::chase()
+{
+    static const size_t columns{1 << 16};
+    static const int ticks{600};
+    static const float columnsPerUnit{256.0f};
+
+    Random random{23};
+    std::vector<unsigned char> map = hillyMap(columns, random);
+    Terrain terrain;
+    terrain.build(map.data(), columns, GameWorld::MapStride, columnsPerUnit);
+
+    float levelWidth = columns / columnsPerUnit;
+    // The player runs back and forth over a tenth of the level.
+    auto playerX = [&](int tick) {
+        return levelWidth * (0.5f + 0.05f * std::sin(tick * 0.01f)) - 0.5f;
+    };
+
+    FlowField field;
+    field.setTarget(terrain, terrain.column(playerX(0)));
+    auto start = Clock::now();
+    field.build(terrain);
+    printf("%zu columns: %zu column window built in %.2f ms\n", columns, field.end() - field.begin(),
+        secondsSince(start) * 1e3);
+
+    // Chasers start within a quarter window of the player, as awake enemies near the camera would.
+    const float spread = FlowField::WindowColumns / 4 / columnsPerUnit;
+    for(size_t chasers : {size_t{10}, size_t{100}, size_t{1000}, size_t{10000}, size_t{100000}})
+    {
+        std::vector<float> xs(chasers);
+        for(float& x : xs)
+        {
+            x = playerX(0) + (random.below(1000000) / 500000.0f - 1.0f) * spread;
+        }
+        std::vector<float> walked = xs;
+
+        start = Clock::now();
+        for(int tick = 0; tick < ticks; ++tick)
+        {
+            size_t target = terrain.column(playerX(tick));
+            field.setTarget(terrain, target);
+            for(float& x : xs)
+            {
+                x += field.direction(terrain.column(x)) * 0.4f * GameWorld::FixedTimestep;
+            }
+        }
+        double fieldSeconds = secondsSince(start);
+        consume(xs);
+
+        // Per-enemy walks get slow, so they only run a few ticks.
+        int walkTicks = chasers > 1000 ? 4 : 60;
+        size_t mismatches{0};
+        start = Clock::now();
+        for(int tick = 0; tick < walkTicks; ++tick)
+        {
+            size_t target = terrain.column(playerX(tick));
+            field.setTarget(terrain, target);
+            for(float& x : walked)
+            {
+                size_t column = terrain.column(x);
+                int direction = walk(terrain, column, target);
+                mismatches += direction != field.direction(column);
+                x += direction * 0.4f * GameWorld::FixedTimestep;
+            }
+        }
+        double walkSeconds = secondsSince(start);
+
+        double perChaser = fieldSeconds / ticks / chasers;
+        printf("%7zu chasers: %.2f ns/chaser, %.1f us/tick with the field; %.0f ns/chaser walking paths%s\n", chasers,
+            perChaser * 1e9, fieldSeconds / ticks * 1e6, walkSeconds / walkTicks / chasers * 1e9,
+            mismatches ? " DIRECTION MISMATCH" : "");
+        if(mismatches)
+        {
+            fail("flow field disagrees with walking the path");
+        }
+    }
+
+    // A player crossing the whole level, a column a tick.
+    int moves{0};
+    start = Clock::now();
+    for(size_t column = 0; column < columns; ++column)
+    {
+        size_t begin = field.begin();
+        field.setTarget(terrain, column);
+        moves += field.begin() != begin;
+    }
+    double sweepSeconds = secondsSince(start);
+    printf("sweep: %d window moves, %.1f us each\n", moves, moves ? sweepSeconds / moves * 1e6 : 0.0);
+    field.setTarget(terrain, terrain.column(playerX(0)));
+
+    // Single column edits re-derive only the run around them, and must agree with a full build.
+    static const int edits{2000};
+    start = Clock::now();
+    for(int i = 0; i < edits; ++i)
+    {
+        size_t column = random.below(columns);
+        int channel = i % 4 == 0 ? 2 : 0;
+        unsigned char& value = map[column * GameWorld::MapStride + channel];
+        value = channel == 2 ? static_cast<unsigned char>(value ^ 0xFF) : static_cast<unsigned char>(random.below(256));
+        terrain.update(column, 1);
+        field.update(terrain, column, 1);
+    }
+    double editSeconds = secondsSince(start);
+    FlowField rebuilt;
+    rebuilt.setTarget(terrain, field.target());
+    rebuilt.build(terrain);
+    size_t wrong{rebuilt.begin() != field.begin()};
+    for(size_t c = field.begin(); c < field.end(); ++c)
+    {
+        wrong += rebuilt.reachRight(c) != field.reachRight(c) || rebuilt.reachLeft(c) != field.reachLeft(c);
+    }
+    printf("edits: %.2f us each including the terrain%s\n", editSeconds / edits * 1e6, wrong ? " REBUILD MISMATCH" : "");
+    if(wrong)
+    {
+        fail("incremental flow field differs from a rebuild");
+    }
+}
@@ -0,0 +1,67 @@
+#include "bench.h"
+
+#include <cmath>
+#include <functional>
+#include "resolutioncontroller.h"
+
+namespace
+{
+    struct Trace
+    {
+        const char* name;
+        /* GPU milliseconds for a frame at full resolution. */
+        std::function<float(int frame)> fullCost;
+    };
+
+    /*
+     * Runs the controller against a synthetic GPU whose time scales with the
+     * pixel count, plus noise. Reports how the scale settled and how often
+     * frames went over budget once it had time to react.
+     */
+    void run(const Trace& trace, int frames)
+    {
+        ResolutionController controller;
+        const float budget = controller.config().budgetMs;
+        unsigned noise{12345};
+        int over{0};
+        int changes{0};
+        float minScale{1.0f};
+        float maxScale{0.0f};
+        for(int frame = 0; frame < frames; ++frame)
+        {
+            noise = noise * 1664525u + 1013904223u;
+            float jitter = 1.0f + ((noise >> 8) % 1000 / 1000.0f - 0.5f) * 0.1f;
+            float scale = controller.scale();
+            float ms = trace.fullCost(frame) * scale * scale * jitter;
+            controller.update(ms);
+            if(frame >= frames / 4)
+            {
+                over += ms > budget * 1.2f;
+                minScale = std::min(minScale, scale);
+                maxScale = std::max(maxScale, scale);
+            }
+            changes = controller.changes();
+        }
+        glm::ivec2 internal = controller.resolution(glm::ivec2(2560, 1440));
+        printf("%-10s final scale %.2f (%dx%d), %3d changes, settled range %.2f-%.2f, %4.1f%% frames >20%% over budget\n",
+            trace.name, controller.scale(), internal.x, internal.y, changes, minScale, maxScale,
+            100.0f * over / (frames - frames / 4));
+    }
+}
+
+void bench::drs()
+{
+    static const int frames{4000};
+    const Trace traces[] = {
+        {"light", [](int) { return 3.0f; }},
+        {"heavy", [](int) { return 12.0f; }},
+        {"extreme", [](int) { return 40.0f; }},
+        {"ramp", [](int frame) { return 4.0f + 8.0f * frame / frames; }},
+        {"spikes", [](int frame) { return frame % 500 < 60 ? 16.0f : 7.0f; }},
+        {"sawtooth", [](int frame) { return 6.0f + 3.0f * std::sin(frame * 0.02f); }},
+    };
+    for(const Trace& trace : traces)
+    {
+        run(trace, frames);
+    }
+}
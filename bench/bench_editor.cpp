@@ -0,0 +1,52 @@
+#include "bench.h"
+
+#include <vector>
+#include "gameworld.h"
+#include "mapeditor.h"
+
+void bench::editor()
+{
+    static const int edits{100000};
+
+    // The cost of an edit should not depend on the level width.
+    for(size_t columns : {size_t{512}, size_t{65536}, size_t{1} << 22})
+    {
+        std::vector<unsigned char> map(columns * GameWorld::MapStride, 0x80);
+        MapEditor editor;
+        editor.setMap(map.data(), columns, GameWorld::MapStride);
+
+        size_t uploaded{0};
+        auto start = Clock::now();
+        for(int i = 0; i < edits; ++i)
+        {
+            size_t column = (i * 7919u) % columns;
+            int channel = i % 2 == 0 ? 0 : 2;
+            editor.set(column, channel, static_cast<unsigned char>(editor.get(column, channel) + 1));
+            editor.flush([&](const MapEditor::Span& span) {
+                uploaded += span.count * GameWorld::MapStride;
+            });
+        }
+        double perEdit = secondsSince(start) / edits;
+
+        // The journal holds the most recent edits; undoing and redoing them
+        // must land on the same bytes.
+        std::vector<unsigned char> edited = map;
+        size_t undone{0};
+        while(editor.undo())
+        {
+            ++undone;
+        }
+        while(editor.redo())
+        {
+        }
+        editor.flush([](const MapEditor::Span&) {});
+        bool restored = undone == MapEditor::MaxJournal && map == edited;
+
+        printf("%8zu columns: %.3f us/edit, %.1f bytes uploaded/edit (full upload %zu)%s\n", columns, perEdit * 1e6,
+            static_cast<double>(uploaded) / edits, columns * GameWorld::MapStride, restored ? "" : " UNDO MISMATCH");
+        if(!restored)
+        {
+            fail("undo and redo did not restore the edits");
+        }
+    }
+}
@@ -0,0 +1,170 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "profiler.h"
+#include "simulationthread.h"
+
+namespace
+{
+    enum class Delivery
+    {
+        /* The old path: the frame loop samples the key state and calls setInput(). */
+        POLLED,
+        /* Events queued with their time at the frame loop's poll, as GLFW delivers them. */
+        QUEUED_AT_POLL,
+        /* Events queued the moment they happen, for input sources with their own thread. */
+        QUEUED
+    };
+
+    const char* name(Delivery delivery)
+    {
+        switch(delivery)
+        {
+        case Delivery::POLLED:
+            return "polled";
+        case Delivery::QUEUED_AT_POLL:
+            return "queued at poll";
+        case Delivery::QUEUED:
+        default:
+            return "queued";
+        }
+    }
+
+    struct Tap
+    {
+        uint64_t down;
+        uint64_t up;
+    };
+
+    /*
+     * Taps jump at uneven times, half of them shorter than a frame, and
+     * measures from each press to the first snapshot with the player off the
+     * ground. A tap that never shows up as a jump is lost.
+     */
+    void run(Delivery delivery, double frameRate)
+    {
+        static const int tapCount{12};
+        static const uint64_t spacing{500000000};
+
+        std::vector<unsigned char> map(512 * GameWorld::MapStride, 0x80);
+        GameWorld world;
+        world.setMap(map.data(), 512);
+        SimulationThread simulation{world};
+
+        uint64_t origin = Profiler::now() + 100000000;
+        std::vector<Tap> taps;
+        unsigned noise{99};
+        for(int i = 0; i < tapCount; ++i)
+        {
+            noise = noise * 1664525u + 1013904223u;
+            uint64_t down = origin + i * spacing + noise % 20000000;
+            uint64_t length = i % 2 ? 3000000 : 60000000;
+            taps.push_back(Tap{down, down + length});
+        }
+        uint64_t end = taps.back().up + spacing;
+
+        // Event source thread for QUEUED, sleeping until each transition.
+        std::thread source;
+        if(delivery == Delivery::QUEUED)
+        {
+            source = std::thread{[&]() {
+                for(const Tap& tap : taps)
+                {
+                    for(auto event : {std::make_pair(tap.down, true), std::make_pair(tap.up, false)})
+                    {
+                        while(Profiler::now() < event.first)
+                        {
+                            std::this_thread::sleep_for(std::chrono::microseconds(100));
+                        }
+                        simulation.inputQueue().push(InputQueue::Button::JUMP, event.second, Profiler::now());
+                    }
+                }
+            }};
+        }
+
+        simulation.start();
+        const auto frame = std::chrono::duration<double>(1.0 / frameRate);
+        std::vector<double> delays;
+        size_t nextTap{0};
+        size_t polledEvents{0};
+        bool airborne{false};
+        WorldSnapshot snapshot;
+        while(Profiler::now() < end)
+        {
+            uint64_t now = Profiler::now();
+            if(delivery == Delivery::POLLED)
+            {
+                GameWorld::Input input;
+                for(const Tap& tap : taps)
+                {
+                    input.jump = input.jump || (tap.down <= now && now < tap.up);
+                }
+                simulation.setInput(input);
+            }
+            else if(delivery == Delivery::QUEUED_AT_POLL)
+            {
+                for(; polledEvents < taps.size() * 2; ++polledEvents)
+                {
+                    const Tap& tap = taps[polledEvents / 2];
+                    bool down = polledEvents % 2 == 0;
+                    if((down ? tap.down : tap.up) > now)
+                    {
+                        break;
+                    }
+                    simulation.inputQueue().push(InputQueue::Button::JUMP, down, now);
+                }
+            }
+
+            // Read snapshots much faster than the frame rate, so the frame
+            // loop's own display delay does not count.
+            auto frameEnd = std::chrono::steady_clock::now() + frame;
+            while(std::chrono::steady_clock::now() < frameEnd)
+            {
+                simulation.read(snapshot);
+                bool up = snapshot.playerPos.y > 0.0f;
+                if(up && !airborne)
+                {
+                    // Credit the jump to the latest tap pressed before the step ran.
+                    while(nextTap + 1 < taps.size() && taps[nextTap + 1].down < snapshot.stamp)
+                    {
+                        ++nextTap;
+                    }
+                    if(nextTap < taps.size() && taps[nextTap].down < snapshot.stamp)
+                    {
+                        delays.push_back((snapshot.stamp - taps[nextTap].down) * 1e-6);
+                        ++nextTap;
+                    }
+                }
+                airborne = up;
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+        simulation.stop();
+        if(source.joinable())
+        {
+            source.join();
+        }
+
+        std::sort(delays.begin(), delays.end());
+        double mean{0.0};
+        for(double delay : delays)
+        {
+            mean += delay / std::max<size_t>(delays.size(), 1);
+        }
+        printf("%-14s at %3.0f fps: %2zu/%d taps became jumps, press to state %5.1f ms mean, %5.1f ms worst\n",
+            name(delivery), frameRate, delays.size(), tapCount, mean, delays.empty() ? 0.0 : delays.back());
+    }
+}
+
+void bench::latency()
+{
+    for(double frameRate : {60.0, 120.0})
+    {
+        for(Delivery delivery : {Delivery::POLLED, Delivery::QUEUED_AT_POLL, Delivery::QUEUED})
+        {
+            run(delivery, frameRate);
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <vector>
+#include "gameworld.h"
+#include "particlesystem.h"
+
+namespace
+{
+    /* The layout the particles would have as one struct each, for comparison. */
+    struct Particle
+    {
+        glm::vec2 position;
+        glm::vec2 velocity;
+        float gravity;
+        float life;
+        float invLifetime;
+        ParticleSystem::Kind kind;
+    };
+
+    void updateStructs(std::vector<Particle>& particles, float dt)
+    {
+        for(Particle& p : particles)
+        {
+            p.velocity.y += p.gravity * dt;
+            p.position += p.velocity * dt;
+            p.life -= dt;
+        }
+        particles.erase(std::remove_if(particles.begin(), particles.end(), [](const Particle& p) {
+            return p.life <= 0.0f;
+        }), particles.end());
+    }
+
+    /* The particles from first on, as structs with the velocity and lifetime the bench gives them all. */
+    void appendStructs(const ParticleSystem& particles, size_t first, std::vector<Particle>& structs)
+    {
+        for(size_t i = first; i < particles.size(); ++i)
+        {
+            structs.push_back(Particle{particles.position(i), glm::vec2(0.1f, 0.2f), -2.0f, particles.fade(i) * 0.7f,
+                1.0f / 0.7f, particles.kind(i)});
+        }
+    }
+
+    /* Tops the system up with bursts of every kind until it is full. */
+    void refill(ParticleSystem& particles)
+    {
+        int kind = 0;
+        while(particles.size() < particles.capacity())
+        {
+            glm::vec2 at(0.01f * (particles.size() % 1000), 0.1f);
+            particles.burst(static_cast<ParticleSystem::Kind>(kind), at);
+            kind = (kind + 1) % ParticleSystem::KindCount;
+        }
+    }
+}
+
+/*
+ * A million particles, integrated for a second of fixed steps with the system
+ * topped up between steps so the count stays near full while bursts expire.
+ * The same particles, topped up with the same bursts, are also stepped as an
+ * array of structs with erase-remove, the straightforward layout; both are
+ * reported per particle integrated. Every live particle must have life left,
+ * and a further second with no new bursts must leave the system empty.
+ */
+void bench::particles()
+{
+    static const size_t capacity{1000000};
+    static const int ticks{120};
+    const float dt = GameWorld::FixedTimestep;
+
+    ParticleSystem particles(capacity);
+    refill(particles);
+
+    // The structs all live 0.7 s, so their count drifts from the system's;
+    // the comparison is per particle integrated.
+    std::vector<Particle> structs;
+    structs.reserve(capacity);
+    appendStructs(particles, 0, structs);
+
+    double soaSeconds{0.0};
+    double structSeconds{0.0};
+    size_t integrated{0};
+    size_t structsIntegrated{0};
+    for(int tick = 0; tick < ticks; ++tick)
+    {
+        integrated += particles.size();
+        auto start = Clock::now();
+        particles.update(dt);
+        soaSeconds += secondsSince(start);
+
+        structsIntegrated += structs.size();
+        start = Clock::now();
+        updateStructs(structs, dt);
+        structSeconds += secondsSince(start);
+
+        size_t first = particles.size();
+        refill(particles);
+        appendStructs(particles, first, structs);
+    }
+    consume(structs.data());
+
+    bool alive = true;
+    for(size_t i = 0; i < particles.size(); ++i)
+    {
+        float fade = particles.fade(i);
+        alive = alive && fade > 0.0f && fade <= 1.0f;
+    }
+
+    for(int tick = 0; tick < ticks; ++tick)
+    {
+        particles.update(dt);
+    }
+
+    printf("%zu particles: %.2f ms/tick, %.2f ns/particle (array of structs %.2f ms/tick, %.2f ns/particle)\n",
+        capacity, soaSeconds / ticks * 1e3, soaSeconds / integrated * 1e9, structSeconds / ticks * 1e3,
+        structSeconds / std::max<size_t>(structsIntegrated, 1) * 1e9);
+    if(!alive)
+    {
+        fail("expired particle kept");
+    }
+    if(particles.size() != 0)
+    {
+        printf("  %zu particles left a second after the last burst\n", particles.size());
+        fail("particles outlived their lifetime");
+    }
+}
@@ -0,0 +1,40 @@
+#include "bench.h"
+
+#include <vector>
+#include "gameworld.h"
+#include "profiler.h"
+
+void bench::profiler()
+{
+    static const int zones{1000000};
+
+    Profiler::clear();
+    auto start = Clock::now();
+    for(int i = 0; i < zones; ++i)
+    {
+        Profiler::Zone zone{"empty"};
+    }
+    double perZone = secondsSince(start) / zones;
+    printf("zone cost: %.1f ns\n", perZone * 1e9);
+
+#ifdef SUSJAM23_PROFILE
+    // Profile a short headless run and export it.
+    std::vector<unsigned char> map(512 * GameWorld::MapStride, 0x80);
+    GameWorld world;
+    world.setMap(map.data(), 512);
+    world.setGodMode(true);
+    world.setSpawns(&bench::levelSpawns());
+    GameWorld::Input input;
+    input.right = true;
+    Profiler::clear();
+    for(int tick = 0; tick < 20000; ++tick)
+    {
+        input.fire = tick % 30 == 0;
+        world.step(GameWorld::FixedTimestep, input);
+    }
+    Profiler::printSummary(stdout);
+    printf("trace: %s\n", Profiler::writeChromeTrace("bench_trace.json") ? "bench_trace.json" : "failed");
+#else
+    printf("zones in the game are compiled out; configure with -DSUSJAM23_PROFILE=ON to record them\n");
+#endif
+}
@@ -0,0 +1,107 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "gameworld.h"
+
+namespace
+{
+    const float ColumnsPerUnit{256.0f};
+
+    /* Flat and dry, so patrols never stop at water and catching up is exact up to rounding. */
+    std::vector<unsigned char> flatMap(size_t columns)
+    {
+        return std::vector<unsigned char>(columns * GameWorld::MapStride, 0x00);
+    }
+
+    void populate(GameWorld& world, size_t enemies, float levelWidth)
+    {
+        world.enemies().reserve(enemies);
+        for(size_t i = 0; i < enemies; ++i)
+        {
+            world.spawnEnemy(glm::vec2(levelWidth * (i + 0.5f) / enemies - 0.5f, 0.0f));
+        }
+    }
+
+    struct Run
+    {
+        double firstTick{0.0};
+        double perTick{0.0};
+        size_t awake{0};
+    };
+
+    /* Runs right across the level; the first tick, which puts most of it to sleep, is timed on its own. */
+    Run run(GameWorld& world, int ticks)
+    {
+        GameWorld::Input input;
+        input.right = true;
+        Run result;
+        auto start = bench::Clock::now();
+        world.step(GameWorld::FixedTimestep, input);
+        result.firstTick = bench::secondsSince(start);
+        start = bench::Clock::now();
+        for(int tick = 1; tick < ticks; ++tick)
+        {
+            world.step(GameWorld::FixedTimestep, input);
+        }
+        result.perTick = bench::secondsSince(start) / (ticks - 1);
+        result.awake = world.enemies().awake();
+        bench::consume(world.playerPos());
+        return result;
+    }
+}
+
+/*
+ * A level with up to 100k placed enemies, stepped with every enemy simulated
+ * and with only those near the camera awake. The per-tick cost with regions
+ * should follow what is on screen and stay flat as the level fills up. Every
+ * sleeper is then woken and checked against where the simulated world has
+ * it, which only rounding should separate.
+ */
+void bench::regions()
+{
+    static const size_t columns{1 << 18};
+    static const int ticks{2400};
+
+    std::vector<unsigned char> map = flatMap(columns);
+    float levelWidth = columns / ColumnsPerUnit;
+    for(size_t enemies : {size_t{1000}, size_t{10000}, size_t{100000}})
+    {
+        GameWorld everything;
+        everything.setMap(map.data(), columns, ColumnsPerUnit);
+        everything.setGodMode(true);
+        everything.setActivationRadius(0.0f);
+        populate(everything, enemies, levelWidth);
+        Run all = run(everything, ticks);
+
+        GameWorld nearby;
+        nearby.setMap(map.data(), columns, ColumnsPerUnit);
+        nearby.setGodMode(true);
+        populate(nearby, enemies, levelWidth);
+        Run regions = run(nearby, ticks);
+
+        // Waking everyone applies the catch-up to every sleeper.
+        nearby.setActivationRadius(0.0f);
+        GameWorld::Input input;
+        input.right = true;
+        everything.step(GameWorld::FixedTimestep, input);
+        nearby.step(GameWorld::FixedTimestep, input);
+        float worst{0.0f};
+        for(size_t i = 0; i < enemies; ++i)
+        {
+            GameWorld::Enemies::Handle handle = everything.enemies().handles()[i];
+            glm::vec2 expected = everything.enemies().positions()[i];
+            glm::vec2 caughtUp = nearby.enemies().positions()[nearby.enemies().indexOf(handle)];
+            worst = std::max(worst, std::abs(expected.x - caughtUp.x));
+        }
+
+        printf("%7zu enemies: %.1f us/tick all awake, %.1f us/tick with regions (%zu awake, first tick %.2f ms);"
+            " catch-up off by %.5f at most\n", enemies, all.perTick * 1e6, regions.perTick * 1e6, regions.awake,
+            regions.firstTick * 1e3, worst);
+        if(nearby.enemies().awake() != enemies || worst > 0.01f)
+        {
+            fail("woken enemies are not where the simulated ones are");
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "softwarerenderer.h"
+
+namespace
+{
+    const char* GoldenImage{"bench/render_golden.ppm"};
+    const glm::ivec2 GoldenResolution{320, 180};
+    /* Per channel, for rounding that differs between compilers. */
+    const int GoldenTolerance{8};
+    /* Pixels allowed past the tolerance, where an edge lands right on a pixel center. */
+    const size_t GoldenOutliers{16};
+
+    /* Compares with the golden image; a frame that differs is written out for inspection. */
+    void checkGolden(SoftwareRenderer& renderer, SoftwareRenderer::Frame frame, const WorldSnapshot& snapshot)
+    {
+        frame.resolution = GoldenResolution;
+        ColumnBins bins;
+        bins.build(snapshot, static_cast<float>(frame.resolution.x) / frame.resolution.y, frame.resolution.x / 16);
+        frame.bins = &bins;
+        std::vector<unsigned char> rgb;
+        renderer.render(frame, rgb);
+
+        std::vector<unsigned char> golden;
+        glm::ivec2 goldenResolution{0};
+        const std::string path = bench::sourceFile(GoldenImage);
+        if(!SoftwareRenderer::readPpm(path, golden, goldenResolution) || goldenResolution != GoldenResolution)
+        {
+            SoftwareRenderer::writePpm("render_golden.ppm", rgb, GoldenResolution);
+            printf("no %dx%d golden image at %s; wrote render_golden.ppm\n", GoldenResolution.x, GoldenResolution.y,
+                path.c_str());
+            bench::fail("golden image missing");
+            return;
+        }
+
+        size_t outliers{0};
+        int worst{0};
+        for(size_t i = 0; i < rgb.size(); i += 3)
+        {
+            int difference{0};
+            for(size_t c = 0; c < 3; ++c)
+            {
+                difference = std::max(difference, std::abs(rgb[i + c] - golden[i + c]));
+            }
+            outliers += difference > GoldenTolerance;
+            worst = std::max(worst, difference);
+        }
+        printf("golden %dx%d: %zu pixels differ, worst by %d\n", GoldenResolution.x, GoldenResolution.y, outliers,
+            worst);
+        if(outliers > GoldenOutliers)
+        {
+            SoftwareRenderer::writePpm("render_actual.ppm", rgb, GoldenResolution);
+            printf("  wrote render_actual.ppm\n");
+            bench::fail("render differs from the golden image");
+        }
+    }
+}
+
+/*
+ * Renders a small scene a few steps in, checked against a golden image and
+ * then timed at full size.
+ */
+void bench::render()
+{
+    static const glm::ivec2 resolution{1440, 800};
+    static const int frames{30};
+    static const int mapWidth{512};
+
+    // Rolling hills with a pond, in the level.png layout.
+    std::vector<unsigned char> map(mapWidth * GameWorld::MapStride, 0);
+    for(int i = 0; i < mapWidth; ++i)
+    {
+        map[i * GameWorld::MapStride + 0] = static_cast<unsigned char>(128 + 40 * std::sin(i * 0.05f));
+        map[i * GameWorld::MapStride + 2] = i > 200 && i < 240 ? 0xFF : 0x00;
+    }
+
+    GameWorld world;
+    world.setMap(map.data(), mapWidth);
+    for(float x : {0.1f, 0.2f, 0.3f, 0.45f, 0.8f})
+    {
+        world.spawnCollectable(glm::vec2(x, 0.08f));
+    }
+    world.spawnEnemy(glm::vec2(0.5f, 0.0f));
+    world.fire();
+    GameWorld::Input input;
+    for(int i = 0; i < 30; ++i)
+    {
+        world.step(GameWorld::FixedTimestep, input);
+    }
+
+    WorldSnapshot snapshot;
+    world.snapshot(snapshot);
+    ColumnBins bins;
+    bins.build(snapshot, static_cast<float>(resolution.x) / resolution.y, resolution.x / 16);
+
+    SoftwareRenderer::Frame frame;
+    frame.resolution = resolution;
+    frame.camera = world.camera2d();
+    frame.playerPos = world.playerPos();
+    frame.time = world.time();
+    frame.shake = world.shake();
+    frame.bins = &bins;
+    frame.map = map.data();
+    frame.mapColumns = mapWidth;
+
+    SoftwareRenderer renderer;
+    checkGolden(renderer, frame, snapshot);
+
+    std::vector<unsigned char> rgb;
+    renderer.render(frame, rgb);
+
+    auto start = Clock::now();
+    for(int i = 0; i < frames; ++i)
+    {
+        frame.time += GameWorld::FixedTimestep;
+        renderer.render(frame, rgb);
+    }
+    double elapsed = secondsSince(start);
+
+    bool written = SoftwareRenderer::writePpm("render.ppm", rgb, resolution);
+    printf("%dx%d: %.1f frames/s, %.2f Mpixels/s%s\n", resolution.x, resolution.y, frames / elapsed,
+        frames * resolution.x * resolution.y / elapsed * 1e-6, written ? ", wrote render.ppm" : "");
+}
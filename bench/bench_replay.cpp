@@ -0,0 +1,174 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include "gameworld.h"
+#include "inputlog.h"
+#include "random.h"
+#include "spawntable.h"
+
+namespace
+{
+    /* Right, back past where the spawned run was trimmed, then right again. */
+    GameWorld::Input scripted(int tick)
+    {
+        GameWorld::Input input;
+        input.right = tick < 6000 || tick >= 10800;
+        input.left = !input.right;
+        input.jump = tick % 90 < 6;
+        input.fire = tick % 40 == 0;
+        return input;
+    }
+
+    /*
+     * A long level with a spawn table, run far enough that the regions behind
+     * the camera are dropped and streamed in again on the way back. Replaying
+     * the log must end on the recorded hash, and so must a world loaded from
+     * a state saved after the first drop and stepped on from there.
+     */
+    void acrossEvictions()
+    {
+        static const size_t columns{1 << 16};
+        static const float columnsPerUnit{256.0f};
+        static const int tickCount{16800};
+        static const int saveTick{8000};
+
+        std::vector<unsigned char> map(columns * GameWorld::MapStride, 0x80);
+        for(size_t c = 0; c < columns; ++c)
+        {
+            map[c * GameWorld::MapStride + 2] = (c % 4096) == 2600 ? 0xFF : 0x00;
+        }
+        float levelWidth = columns / columnsPerUnit;
+        Random random{7};
+        std::vector<SpawnTable::Spawn> list;
+        for(int i = 0; i < 3000; ++i)
+        {
+            float x = 1.0f + random.below(1000000) / 1000000.0f * (levelWidth - 2.0f);
+            list.push_back(i % 8 != 0 ? SpawnTable::Spawn{SpawnTable::Type::COLLECTABLE, glm::vec2(x, 0.08f)}
+                : SpawnTable::Spawn{SpawnTable::Type::ENEMY, glm::vec2(x, 0.0f)});
+        }
+        SpawnTable table;
+        table.assign(list);
+
+        InputLog log;
+        GameWorld recorded;
+        recorded.setMap(map.data(), columns, columnsPerUnit);
+        recorded.setSeed(99);
+        recorded.setGodMode(true);
+        recorded.setSpawns(&table);
+        log.begin(99, "synthetic", InputLog::hashMap(map.data(), map.size()), InputLog::hashSpawns(&table), columns,
+            columnsPerUnit);
+        recorded.setRecorder(&log);
+        std::vector<unsigned char> saved;
+        size_t furthest{0};
+        for(int tick = 0; tick < tickCount; ++tick)
+        {
+            if(tick == saveTick)
+            {
+                recorded.saveState(saved);
+            }
+            recorded.step(GameWorld::FixedTimestep, scripted(tick));
+            furthest = std::max(furthest, recorded.activation().first());
+        }
+        recorded.setRecorder(nullptr);
+        log.finish(recorded.stateHash());
+
+        GameWorld replayed;
+        replayed.setMap(map.data(), columns, columnsPerUnit);
+        replayed.setGodMode(true);
+        replayed.setSpawns(&table);
+        uint64_t hash = log.replay(replayed);
+
+        GameWorld resumed;
+        resumed.setMap(map.data(), columns, columnsPerUnit);
+        resumed.setSpawns(&table);
+        bool loaded = resumed.loadState(saved.data(), saved.size());
+        for(int tick = saveTick; loaded && tick < tickCount; ++tick)
+        {
+            resumed.step(GameWorld::FixedTimestep, scripted(tick));
+        }
+
+        bool crossed = furthest > 2 * GameWorld::KeptSpawnRegions;
+        printf("%d ticks over %zu spawns, awake from region %zu at most: replay %s, resumed from tick %d %s\n",
+            tickCount, table.size(), furthest, hash == log.header().finalHash ? "matches" : "MISMATCH", saveTick,
+            loaded && resumed.stateHash() == log.header().finalHash ? "matches" : "MISMATCH");
+        if(!crossed)
+        {
+            bench::fail("the run never went past the kept regions");
+        }
+        if(hash != log.header().finalHash || !loaded || resumed.stateHash() != log.header().finalHash)
+        {
+            bench::fail("replay across dropped regions ended on a different state");
+        }
+    }
+}
+
+void bench::replay()
+{
+    static const int width{512};
+    static const unsigned long long tickCount{2000000};
+    static const char* path{"bench_replay.sjr"};
+
+    std::vector<unsigned char> map(width * GameWorld::MapStride, 0x80);
+    for(int i = 0; i < width; ++i)
+    {
+        map[i * GameWorld::MapStride + 2] = (i % 64) == 40 ? 0xFF : 0x00;
+    }
+
+    // Record a scripted session the way App does, with input that changes
+    // every few frames like a player's would.
+    InputLog log;
+    GameWorld recorded;
+    recorded.setMap(map.data(), width);
+    recorded.setSeed(1234);
+    recorded.setSpawns(&bench::levelSpawns());
+    log.begin(1234, "synthetic", InputLog::hashMap(map.data(), map.size()), InputLog::hashSpawns(&bench::levelSpawns()),
+        width, recorded.columnsPerUnit());
+    recorded.setRecorder(&log);
+    GameWorld::Input input;
+    for(unsigned long long tick = 0; tick < tickCount; tick += 2)
+    {
+        input.right = (tick / 500) % 5 != 4;
+        input.left = !input.right;
+        input.jump = tick % 90 < 6;
+        input.fire = tick % 40 == 0;
+        input.shake = tick % 1000 == 0;
+        recorded.advance(2 * GameWorld::FixedTimestep, input);
+    }
+    recorded.setRecorder(nullptr);
+    log.finish(recorded.stateHash());
+
+    if(!log.save(path))
+    {
+        printf("failed to write %s\n", path);
+        fail("input log not written");
+        return;
+    }
+    FILE* file = fopen(path, "rb");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+
+    InputLog loaded;
+    bool ok = loaded.load(path) && loaded.header().spawnHash == InputLog::hashSpawns(&bench::levelSpawns());
+    remove(path);
+
+    GameWorld world;
+    world.setMap(map.data(), width);
+    world.setSpawns(&bench::levelSpawns());
+    auto start = Clock::now();
+    uint64_t hash = ok ? loaded.replay(world) : 0;
+    double elapsed = secondsSince(start);
+
+    double rate = loaded.header().tickCount / elapsed;
+    printf("%llu ticks, %zu runs, %ld byte log: replay %.0f ticks/s (%.0fx real time), hash %s\n",
+        static_cast<unsigned long long>(loaded.header().tickCount), loaded.runs().size(), size, rate,
+        rate * GameWorld::FixedTimestep, ok && hash == log.header().finalHash ? "matches" : "MISMATCH");
+    if(!ok || hash != log.header().finalHash)
+    {
+        fail("replay ended on a different state");
+    }
+
+    acrossEvictions();
+}
@@ -0,0 +1,103 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <vector>
+#include "gameworld.h"
+#include "random.h"
+#include "rewindbuffer.h"
+
+namespace
+{
+    void run(int extraEnemies, size_t budgetMB, unsigned long long tickCount)
+    {
+        static const int width{512};
+        static const int restores{2000};
+
+        std::vector<unsigned char> map(width * GameWorld::MapStride, 0x80);
+        for(int i = 0; i < width; ++i)
+        {
+            map[i * GameWorld::MapStride + 2] = (i % 64) == 40 ? 0xFF : 0x00;
+        }
+
+        GameWorld world;
+        world.setMap(map.data(), width);
+        world.setSeed(99);
+        world.setSpawns(&bench::levelSpawns());
+        for(int i = 0; i < extraEnemies; ++i)
+        {
+            world.spawnEnemy(glm::vec2(0.5f + 3.0f * i / extraEnemies, 0.0f));
+        }
+
+        RewindBuffer::Config config;
+        config.budgetBytes = budgetMB << 20;
+        RewindBuffer rewind{config};
+        std::vector<uint64_t> hashes;
+        hashes.reserve(tickCount);
+
+        GameWorld::Input input;
+        double pushSeconds{0.0};
+        for(unsigned long long tick = 0; tick < tickCount; ++tick)
+        {
+            input.right = (tick / 500) % 5 != 4;
+            input.left = !input.right;
+            input.jump = tick % 90 < 6;
+            input.fire = tick % 40 == 0;
+            world.step(GameWorld::FixedTimestep, input);
+            hashes.push_back(world.stateHash());
+
+            auto start = bench::Clock::now();
+            rewind.push(world);
+            pushSeconds += bench::secondsSince(start);
+        }
+
+        std::vector<unsigned char> raw;
+        world.saveState(raw);
+        double bytesPerTick = static_cast<double>(rewind.bytes()) / rewind.frames();
+        double heldSeconds = rewind.frames() * GameWorld::FixedTimestep;
+
+        // Random restores, then a scrub backwards over a few seconds.
+        Random random{7};
+        GameWorld restored;
+        restored.setMap(map.data(), width);
+        int mismatches{0};
+        auto start = bench::Clock::now();
+        for(int i = 0; i < restores; ++i)
+        {
+            unsigned long long tick = rewind.oldestTick() + random.below(static_cast<uint32_t>(rewind.frames()));
+            if(!rewind.restore(tick, restored) || restored.stateHash() != hashes[tick - 1])
+            {
+                ++mismatches;
+            }
+        }
+        double randomSeconds = bench::secondsSince(start) / restores;
+
+        start = bench::Clock::now();
+        int scrubbed{0};
+        for(unsigned long long tick = rewind.newestTick(); tick > rewind.newestTick() - 600 && tick >= rewind.oldestTick(); --tick)
+        {
+            if(!rewind.restore(tick, restored) || restored.stateHash() != hashes[tick - 1])
+            {
+                ++mismatches;
+            }
+            ++scrubbed;
+        }
+        double scrubSeconds = bench::secondsSince(start) / std::max(scrubbed, 1);
+
+        printf("%6zu enemies, %3zu MB budget: state %7zu bytes, push %6.2f us/tick, %8.0f bytes/tick = %6.1f KB/s,"
+            " %6.1f s held, restore %6.1f us random, %6.1f us scrubbing%s\n",
+            world.enemies().size(), budgetMB, raw.size(), pushSeconds / tickCount * 1e6, bytesPerTick,
+            bytesPerTick / GameWorld::FixedTimestep / 1024.0, heldSeconds, randomSeconds * 1e6, scrubSeconds * 1e6,
+            mismatches ? " MISMATCH" : "");
+        if(mismatches)
+        {
+            bench::fail("restored state differs from the recorded one");
+        }
+    }
+}
+
+void bench::rewind()
+{
+    run(0, 16, 20000);
+    run(1000, 16, 20000);
+    run(10000, 4, 2000);
+}
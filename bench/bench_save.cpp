@@ -0,0 +1,116 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include "gameworld.h"
+#include "levelimage.h"
+#include "mapeditor.h"
+#include "mapsaver.h"
+
+namespace
+{
+    /* CPU time of the calling thread, which the writer waking up on the same core does not add to. */
+    double threadSeconds()
+    {
+        timespec now;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return now.tv_sec + now.tv_nsec * 1e-9;
+    }
+}
+
+/*
+ * Editing with a save every few frames, as with Alt+S in the game. The frame
+ * side of a save should stay in microseconds whatever the level width; the
+ * writer's encode and write time is what a synchronous save used to cost.
+ * On a single core the writer may run before save() returns, so the frame
+ * side is reported as thread CPU time next to the wall time.
+ */
+void bench::save()
+{
+    static const char* path{"bench_save.png"};
+    static const int frames{400};
+    static const int saveEvery{40};
+
+    for(size_t columns : {size_t{512}, size_t{65536}, size_t{1} << 22})
+    {
+        std::vector<unsigned char> map(columns * GameWorld::MapStride);
+        for(size_t i = 0; i < columns; ++i)
+        {
+            map[i * GameWorld::MapStride + 0] = static_cast<unsigned char>(0x60 + (i / 64) % 64);
+            map[i * GameWorld::MapStride + 2] = (i % 700) == 600 ? 0xFF : 0x00;
+            map[i * GameWorld::MapStride + 3] = 0xFF;
+        }
+        std::vector<unsigned char> original = map;
+        remove(MapSaver::journalPath(path).c_str());
+
+        MapEditor editor;
+        editor.setMap(map.data(), columns, GameWorld::MapStride);
+        double worstSave{0.0};
+        double totalSave{0.0};
+        double totalSaveCpu{0.0};
+        int saves{0};
+        double writeSeconds{0.0};
+        {
+            MapSaver saver;
+            auto start = Clock::now();
+            saver.setMap(map.data(), static_cast<int>(columns), 1, GameWorld::MapStride, path);
+            double load = secondsSince(start);
+
+            for(int frame = 0; frame < frames; ++frame)
+            {
+                size_t column = (frame * 7919u) % columns;
+                editor.set(column, 0, static_cast<unsigned char>(editor.get(column, 0) + 1));
+                editor.flush([&](const MapEditor::Span& span) {
+                    saver.changed(span);
+                });
+                if(frame % saveEvery == saveEvery - 1)
+                {
+                    // Saves are seconds apart in play, so let the last one finish rather than
+                    // timing the writer stealing this core.
+                    saver.wait();
+                    auto saveStart = Clock::now();
+                    double cpuStart = threadSeconds();
+                    saver.save();
+                    totalSaveCpu += threadSeconds() - cpuStart;
+                    double seconds = secondsSince(saveStart);
+                    worstSave = std::max(worstSave, seconds);
+                    totalSave += seconds;
+                    ++saves;
+                }
+            }
+            saver.wait();
+            writeSeconds = saver.stats().lastWriteSeconds;
+
+            // Edits after the last save only reach the journal.
+            for(int i = 0; i < 16; ++i)
+            {
+                size_t column = (i * 104729u) % columns;
+                editor.set(column, 2, static_cast<unsigned char>(editor.get(column, 2) ^ 0xFF));
+            }
+            editor.flush([&](const MapEditor::Span& span) {
+                saver.changed(span);
+            });
+            printf("%8zu columns: save %.1f us cpu, %.1f us wall mean, %.1f us worst on the frame;"
+                " writer %.2f ms per save; copy at load %.2f ms\n", columns, totalSaveCpu / saves * 1e6,
+                totalSave / saves * 1e6, worstSave * 1e6, writeSeconds * 1e3, load * 1e3);
+        }
+
+        // The saved image plus the journal must give back the edited map.
+        LevelImage image;
+        bool matches = image.load(path) && static_cast<size_t>(image.width()) == columns && image.height() == 1;
+        if(matches)
+        {
+            std::vector<unsigned char> restored(image.bytes(), image.bytes() + columns * GameWorld::MapStride);
+            matches = restored == map && restored != original;
+        }
+        if(!matches)
+        {
+            printf("  saved image and journal do not match the edited map\n");
+            fail("map save mismatch");
+        }
+        remove(path);
+        remove(MapSaver::journalPath(path).c_str());
+    }
+}
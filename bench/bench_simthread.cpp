@@ -0,0 +1,60 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "profiler.h"
+#include "simulationthread.h"
+
+void bench::simthread()
+{
+    static const double seconds{2.0};
+    static const int maxStaleSteps{4};
+
+    std::vector<unsigned char> map(512 * GameWorld::MapStride, 0x80);
+    GameWorld world;
+    world.setMap(map.data(), 512);
+    world.setSpawns(&bench::levelSpawns());
+    for(int i = 0; i < 1000; ++i)
+    {
+        world.spawnCollectable(glm::vec2(i * 0.05f, 0.08f));
+    }
+
+    // A render loop that is deliberately slower than the simulation on some
+    // frames; the step rate should not notice.
+    SimulationThread simulation{world};
+    simulation.start();
+    WorldSnapshot snapshot;
+    GameWorld::Input input;
+    input.right = true;
+    int frames{0};
+    double worstStale{0.0};
+    auto start = Clock::now();
+    while(secondsSince(start) < seconds)
+    {
+        input.fire = frames % 20 == 0;
+        simulation.setInput(input);
+        if(simulation.read(snapshot))
+        {
+            worstStale = std::max(worstStale, (Profiler::now() - snapshot.stamp) * 1e-6);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(frames % 30 == 0 ? 40 : 4));
+        ++frames;
+    }
+    simulation.stop();
+    double elapsed = secondsSince(start);
+
+    double rate = simulation.steps() / elapsed;
+    double target = 1.0 / GameWorld::FixedTimestep;
+    printf("render %.0f fps with stalls, simulation %.1f steps/s (target %.0f), newest snapshot at most %.1f ms old\n",
+        frames / elapsed, rate, target, worstStale);
+    if(rate < target * 0.9)
+    {
+        fail("simulation fell behind its step rate");
+    }
+    // A frame sees the step published while it slept, whatever the stall.
+    if(worstStale > maxStaleSteps * GameWorld::FixedTimestep * 1e3)
+    {
+        fail("snapshot older than a few steps");
+    }
+}
@@ -0,0 +1,236 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include "gameworld.h"
+#include "random.h"
+#include "spawntable.h"
+
+namespace
+{
+    const float ColumnsPerUnit{256.0f};
+
+    bool byPosition(const glm::vec2& a, const glm::vec2& b)
+    {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    }
+
+    /* How many of world's enemies came from each of the first count table entries. */
+    std::vector<int> enemiesPerEntry(const GameWorld& world, size_t count)
+    {
+        std::vector<int> perEntry(count, 0);
+        const GameWorld::Enemies& enemies = world.enemies();
+        for(size_t i = 0; i < enemies.size(); ++i)
+        {
+            uint32_t entry = enemies.infos()[i].entry;
+            if(entry < count)
+            {
+                ++perEntry[entry];
+            }
+        }
+        return perEntry;
+    }
+
+    /*
+     * A chaser kept in tow, stop and go, until the spawned regions are trimmed
+     * past where it came from, then the run back there with it still chasing.
+     * Streaming its region in again must not make a second one, and the
+     * patroller next to it must come back exactly once.
+     */
+    void chaserInTow()
+    {
+        static const size_t columns{1 << 16};
+        static const float chaserX{2.0f};
+        std::vector<unsigned char> map(columns * GameWorld::MapStride, 0x80);
+        for(size_t c = 0; c < columns; ++c)
+        {
+            map[c * GameWorld::MapStride + 2] = 0x00;
+        }
+        SpawnTable table;
+        table.assign({{SpawnTable::Type::ENEMY, glm::vec2(chaserX, 0.0f)},
+            {SpawnTable::Type::ENEMY, glm::vec2(chaserX + 0.5f, 0.0f)}});
+
+        GameWorld world;
+        world.setMap(map.data(), columns, ColumnsPerUnit);
+        world.setGodMode(true);
+        world.setSpawns(&table);
+        // Past both, then the first turns to chase; god mode only keeps one
+        // from starting on its own.
+        GameWorld::Input input;
+        input.right = true;
+        int ticks{0};
+        while(world.playerPos().x < chaserX + 1.0f)
+        {
+            world.step(GameWorld::FixedTimestep, input);
+            ++ticks;
+        }
+        GameWorld::Enemies& enemies = world.enemies();
+        size_t chaser = enemies.infos()[0].entry == 0 ? 0 : 1;
+        enemies.states()[chaser].chasingPlayer = true;
+        uint32_t chaserHandle = enemies.handles()[chaser];
+
+        // Far enough that the regions around the chaser's start are dropped.
+        const ActivationRegions& regions = world.activation();
+        size_t origin = regions.region(chaserX);
+        while(regions.first() <= origin + GameWorld::KeptSpawnRegions + 2 && ticks < 100000)
+        {
+            bool towing = enemies.alive(chaserHandle);
+            float gap = towing ? world.playerPos().x - enemies.positions()[enemies.indexOf(chaserHandle)].x : 0.0f;
+            input.right = !towing || gap < 1.0f;
+            world.step(GameWorld::FixedTimestep, input);
+            ++ticks;
+        }
+        bool towed = enemies.alive(chaserHandle);
+        float furthest = world.playerPos().x;
+
+        // Back with it in tow, stop and go again. Passing it would end the
+        // chase in god mode, so it is kept at it, as it would be by a player
+        // jumping over it.
+        input.right = false;
+        while(world.playerPos().x > chaserX + 0.25f && ticks < 200000)
+        {
+            bool towing = enemies.alive(chaserHandle);
+            float gap = towing ? enemies.positions()[enemies.indexOf(chaserHandle)].x - world.playerPos().x : 0.0f;
+            input.left = !towing || gap < 1.0f;
+            if(towing)
+            {
+                enemies.states()[enemies.indexOf(chaserHandle)].chasingPlayer = true;
+            }
+            world.step(GameWorld::FixedTimestep, input);
+            ++ticks;
+        }
+        towed = towed && enemies.alive(chaserHandle);
+        std::vector<int> perEntry = enemiesPerEntry(world, table.size());
+
+        printf("chaser towed to x = %.1f and back in %d ticks: %d chaser, %d patroller, %zu enemies\n", furthest,
+            ticks, perEntry[0], perEntry[1], enemies.size());
+        if(!towed)
+        {
+            bench::fail("chaser lost on the way");
+        }
+        if(perEntry[0] != 1 || perEntry[1] != 1 || enemies.size() != 2)
+        {
+            bench::fail("enemies duplicated or lost streaming back into a trimmed region");
+        }
+    }
+}
+
+/*
+ * A long level with 500k pickups and 50k enemies in its spawn table. Spawning
+ * all of it up front, as the hard-coded lists did, is timed against mapping
+ * the table and streaming it in while running a stretch of the level. Opening
+ * should not depend on the entry count, and the pools should hold only what
+ * is near the camera; the collectables in them must be exactly the table's
+ * within the regions kept around it.
+ */
+void bench::spawns()
+{
+    static const size_t columns{1 << 22};
+    static const size_t pickups{500000};
+    static const size_t enemies{50000};
+    static const int ticks{6000};
+    static const char* path{"bench_spawns.spawns"};
+
+    std::vector<unsigned char> map(columns * GameWorld::MapStride, 0x00);
+    float levelWidth = columns / ColumnsPerUnit;
+    Random random{24};
+    std::vector<SpawnTable::Spawn> list;
+    list.reserve(pickups + enemies);
+    for(size_t i = 0; i < pickups + enemies; ++i)
+    {
+        float x = random.below(1000000) / 1000000.0f * levelWidth - 0.5f;
+        list.push_back(i < pickups ? SpawnTable::Spawn{SpawnTable::Type::COLLECTABLE, glm::vec2(x, 0.08f)}
+            : SpawnTable::Spawn{SpawnTable::Type::ENEMY, glm::vec2(x, 0.0f)});
+    }
+    if(!SpawnTable::write(path, list))
+    {
+        printf("failed to write %s\n", path);
+        fail("spawn table not written");
+        return;
+    }
+
+    // Everything at once, the way the hard-coded lists were spawned.
+    auto start = Clock::now();
+    {
+        GameWorld world;
+        world.setMap(map.data(), columns, ColumnsPerUnit);
+        for(const SpawnTable::Spawn& spawn : list)
+        {
+            if(spawn.type == SpawnTable::Type::COLLECTABLE)
+            {
+                world.spawnCollectable(spawn.position);
+            }
+            else
+            {
+                world.spawnEnemy(spawn.position);
+            }
+        }
+        consume(world.enemies().size());
+    }
+    double upFront = secondsSince(start);
+
+    start = Clock::now();
+    SpawnTable table;
+    bool opened = table.open(path);
+    double openSeconds = secondsSince(start);
+    if(!opened || table.size() != list.size())
+    {
+        printf("failed to open %s\n", path);
+        fail("spawn table not readable");
+        remove(path);
+        return;
+    }
+
+    GameWorld world;
+    world.setMap(map.data(), columns, ColumnsPerUnit);
+    world.setGodMode(true);
+    world.setSpawns(&table);
+    GameWorld::Input input;
+    input.right = true;
+    double worstTick{0.0};
+    start = Clock::now();
+    for(int tick = 0; tick < ticks; ++tick)
+    {
+        auto tickStart = Clock::now();
+        world.step(GameWorld::FixedTimestep, input);
+        worstTick = std::max(worstTick, secondsSince(tickStart));
+    }
+    double perTick = secondsSince(start) / ticks;
+
+    // Every collectable of the regions kept around the camera, and nothing
+    // else. The run started at the camera, so nothing before it was spawned.
+    const ActivationRegions& regions = world.activation();
+    size_t first = std::max(regions.region(-regions.radius()),
+        regions.first() > GameWorld::KeptSpawnRegions ? regions.first() - GameWorld::KeptSpawnRegions : 0);
+    size_t last = regions.last();
+    std::vector<glm::vec2> expected;
+    for(size_t i = 0; i < table.size(); ++i)
+    {
+        glm::vec2 position = SpawnTable::position(table.entries()[i]);
+        size_t region = regions.region(position.x);
+        if(table.entries()[i].type == SpawnTable::Type::COLLECTABLE && region >= first && region <= last)
+        {
+            expected.push_back(position);
+        }
+    }
+    const GameWorld::Collectables& streamed = world.collectables();
+    std::vector<glm::vec2> actual(streamed.positions(), streamed.positions() + streamed.size());
+    std::sort(expected.begin(), expected.end(), byPosition);
+    std::sort(actual.begin(), actual.end(), byPosition);
+
+    printf("%zu spawns, %zu KB table: all up front %.1f ms; open %.3f ms, then %.2f us/tick, worst %.1f us streaming\n",
+        table.size(), (sizeof(SpawnTable::Header) + table.size() * sizeof(SpawnTable::Entry)) / 1024,
+        upFront * 1e3, openSeconds * 1e3, perTick * 1e6, worstTick * 1e6);
+    printf("after %.0f units: %zu collectables and %zu enemies in the pools, %zu awake\n", world.playerPos().x,
+        streamed.size(), world.enemies().size(), streamed.awake() + world.enemies().awake());
+    if(actual != expected)
+    {
+        printf("  streamed %zu collectables, the table has %zu in range\n", actual.size(), expected.size());
+        fail("streamed spawns differ from the table");
+    }
+    table.close();
+    remove(path);
+
+    chaserInTow();
+}
@@ -0,0 +1,109 @@
+#include "bench.h"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "frameuniforms.h"
+#include "gameworld.h"
+#include "levelimage.h"
+#include "mapsaver.h"
+#include "startuploader.h"
+
+namespace
+{
+    /* Stands in for creating the window and GL context, which the bench cannot do. */
+    const std::chrono::milliseconds ContextCreation{120};
+
+    struct Loaded
+    {
+        LevelImage image;
+        std::string shader;
+    };
+
+    void loadLevel(Loaded& loaded, const char* path)
+    {
+        loaded.image.load(path);
+    }
+
+    /* The generated part of the screen shader; the rest is a constant. */
+    void buildShader(Loaded& loaded)
+    {
+        loaded.shader = frameDeclarations();
+    }
+}
+
+/*
+ * Time until the first frame could start, with level decoding and shader
+ * sources done on the main thread after the context, as before, and on
+ * StartupLoader threads during it. The overlapped time should stay at the
+ * context creation time until decoding alone takes longer.
+ */
+void bench::startup()
+{
+    static const char* path{"bench_startup.png"};
+
+    for(size_t columns : {size_t{4096}, size_t{1} << 20, size_t{1} << 22})
+    {
+        std::vector<unsigned char> map(columns * GameWorld::MapStride);
+        for(size_t i = 0; i < columns; ++i)
+        {
+            map[i * GameWorld::MapStride + 0] = static_cast<unsigned char>(0x60 + (i * 2654435761u >> 24) % 64);
+            map[i * GameWorld::MapStride + 2] = (i % 700) == 600 ? 0xFF : 0x00;
+            map[i * GameWorld::MapStride + 3] = 0xFF;
+        }
+        {
+            MapSaver saver;
+            saver.setMap(map.data(), static_cast<int>(columns), 1, GameWorld::MapStride, path);
+            saver.save();
+            saver.wait();
+            if(saver.stats().saves != 1)
+            {
+                printf("failed to write %s\n", path);
+                fail("startup level not written");
+                return;
+            }
+        }
+        remove(MapSaver::journalPath(path).c_str());
+
+        auto start = Clock::now();
+        Loaded serial;
+        std::this_thread::sleep_for(ContextCreation);
+        loadLevel(serial, path);
+        buildShader(serial);
+        double serialSeconds = secondsSince(start);
+
+        Loaded overlapped;
+        StartupLoader loader;
+        StartupLoader::Task level = loader.start("load level", [&overlapped]() {
+            loadLevel(overlapped, path);
+        });
+        StartupLoader::Task shader = loader.start("shader sources", [&overlapped]() {
+            buildShader(overlapped);
+        });
+        loader.phase("window");
+        std::this_thread::sleep_for(ContextCreation);
+        loader.phase("pipeline");
+        loader.join(shader);
+        loader.phase("level");
+        loader.join(level);
+        loader.finish();
+
+        bool matches = overlapped.image.width() == static_cast<int>(columns)
+            && std::memcmp(overlapped.image.bytes(), map.data(), map.size()) == 0
+            && overlapped.shader == serial.shader;
+        printf("%8zu columns: serial %.1f ms, overlapped %.1f ms to first frame (context %lld ms)\n", columns,
+            serialSeconds * 1e3, loader.total() * 1e-6, static_cast<long long>(ContextCreation.count()));
+        if(columns == (size_t{1} << 22))
+        {
+            loader.printBreakdown(stdout);
+        }
+        if(!matches)
+        {
+            printf("  loaded level does not match what was written\n");
+            fail("startup level mismatch");
+        }
+    }
+    remove(path);
+}
@@ -0,0 +1,210 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <vector>
+#include "gameworld.h"
+#include "levelfile.h"
+
+namespace
+{
+    /* Resident set size in bytes, from /proc/self/statm. */
+    size_t residentBytes()
+    {
+        size_t pages{0};
+        size_t resident{0};
+        FILE* file = fopen("/proc/self/statm", "r");
+        if(file == nullptr)
+        {
+            return 0;
+        }
+        if(fscanf(file, "%zu %zu", &pages, &resident) != 2)
+        {
+            resident = 0;
+        }
+        fclose(file);
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    struct Walk
+    {
+        bool ok{false};
+        size_t baseline{0};
+        size_t peak{0};
+        size_t changed{0};
+        uint64_t residentChunks{0};
+        double writeSeconds{0.0};
+        double walkSeconds{0.0};
+    };
+
+    const float ColumnsPerUnit{128.0f};
+    const int Frames{20000};
+
+    /*
+     * Writes a level of columnCount columns, then opens it and walks the
+     * camera from one end to the other, touching the columns the terrain pass
+     * would read and querying the ground around the camera each frame.
+     */
+    Walk walk(const char* path, uint64_t columnCount)
+    {
+        static const uint64_t radius{static_cast<uint64_t>(ColumnsPerUnit * 8.0f)};
+
+        Walk result;
+        auto start = bench::Clock::now();
+        bool written = LevelFile::write(path, columnCount, ColumnsPerUnit,
+            [](uint64_t first, uint64_t count, unsigned char* out) {
+                for(uint64_t i = 0; i < count; ++i)
+                {
+                    uint64_t column = first + i;
+                    out[i * 4 + 0] = static_cast<unsigned char>(128 + 40 * std::sin(column * 0.01));
+                    out[i * 4 + 1] = 0x00;
+                    out[i * 4 + 2] = column % 4096 < 512 ? 0xFF : 0x00;
+                    out[i * 4 + 3] = 0xFF;
+                }
+            });
+        result.writeSeconds = bench::secondsSince(start);
+        if(!written)
+        {
+            printf("failed to write %s\n", path);
+            return result;
+        }
+
+        // Everything from opening the level on counts against it.
+        result.baseline = residentBytes();
+        result.peak = result.baseline;
+        {
+            LevelFile level;
+            if(!level.open(path))
+            {
+                printf("failed to open %s\n", path);
+                remove(path);
+                return result;
+            }
+            GameWorld world;
+            world.setMap(level.columns(), level.columnCount(), level.columnsPerUnit());
+            result.peak = std::max(result.peak, residentBytes());
+
+            uint64_t sum{0};
+            const float length = columnCount / ColumnsPerUnit;
+            start = bench::Clock::now();
+            for(int frame = 0; frame < Frames; ++frame)
+            {
+                float x = length * frame / Frames;
+                size_t column = world.mapColumn(x);
+                result.changed += level.page(column, radius);
+                size_t first = column > radius / 2 ? column - radius / 2 : 0;
+                size_t last = std::min<size_t>(column + radius / 2, level.columnCount());
+                for(size_t i = first; i < last; i += 64)
+                {
+                    sum += level.columns()[i * LevelFile::BytesPerColumn];
+                }
+                sum += world.terrain().waterBetween(x - 2.0f, x + 2.0f);
+                sum += static_cast<uint64_t>(world.terrain().height(x) > 0.0f);
+                if(frame % 256 == 0)
+                {
+                    result.peak = std::max(result.peak, residentBytes());
+                }
+            }
+            result.walkSeconds = bench::secondsSince(start);
+            result.peak = std::max(result.peak, residentBytes());
+            result.residentChunks = level.residentChunks();
+            bench::consume(sum);
+        }
+        remove(path);
+        result.ok = true;
+        return result;
+    }
+}
+
+namespace
+{
+    /*
+     * A small level, then copies of it with one header or index field
+     * damaged. Each copy must be refused before anything reads through it.
+     */
+    bool rejectsDamaged(const char* path)
+    {
+        static const uint64_t columnCount{10000};
+        std::vector<unsigned char> columns(columnCount * LevelFile::BytesPerColumn, 0x80);
+        LevelFile level;
+        if(!LevelFile::write(path, columns.data(), columnCount, ColumnsPerUnit) || !level.open(path))
+        {
+            return false;
+        }
+        LevelFile::Header header = level.header();
+        level.close();
+        std::vector<unsigned char> bytes;
+        FILE* file = fopen(path, "rb");
+        for(int c = fgetc(file); c != EOF; c = fgetc(file))
+        {
+            bytes.push_back(static_cast<unsigned char>(c));
+        }
+        fclose(file);
+
+        auto refused = [&](auto damage) {
+            std::vector<unsigned char> copy(bytes);
+            LevelFile::Header h = header;
+            LevelFile::ChunkEntry* index = reinterpret_cast<LevelFile::ChunkEntry*>(copy.data() + h.indexOffset);
+            damage(h, index);
+            std::memcpy(copy.data(), &h, sizeof(h));
+            FILE* out = fopen(path, "wb");
+            fwrite(copy.data(), 1, copy.size(), out);
+            fclose(out);
+            return !level.open(path);
+        };
+        bool ok = refused([](LevelFile::Header& h, LevelFile::ChunkEntry*) { h.columnsPerUnit = NAN; })
+            && refused([](LevelFile::Header& h, LevelFile::ChunkEntry*) { h.columnsPerUnit = 0.0f; })
+            && refused([](LevelFile::Header& h, LevelFile::ChunkEntry*) { h.indexOffset = ~0ull - 8; })
+            && refused([](LevelFile::Header& h, LevelFile::ChunkEntry*) {
+                   h.columnCount = ~0ull - 1;
+                   h.chunkCount = h.columnCount / h.columnsPerChunk + 1;
+               })
+            && refused([](LevelFile::Header&, LevelFile::ChunkEntry* index) { index[0].size -= 4; });
+        remove(path);
+        return ok;
+    }
+}
+
+/*
+ * Streams a 1M and a 10M column level past the camera. Resident memory from
+ * opening the level on must not grow with its length: the longer level may
+ * only add a sixteenth of the difference in size.
+ */
+void bench::stream()
+{
+    static const uint64_t sizes[] = {1'000'000, 10'000'000};
+    static const char* path{"bench_stream.sjl"};
+
+    size_t growth[2]{};
+    for(int i = 0; i < 2; ++i)
+    {
+        Walk result = walk(path, sizes[i]);
+        if(!result.ok)
+        {
+            fail("level not streamed");
+            return;
+        }
+        growth[i] = result.peak - result.baseline;
+        printf("%llu columns (%.0f MB): written in %.2f s, walked %d frames in %.2f s, %.0f chunk changes/s, "
+            "%llu chunks resident\n", static_cast<unsigned long long>(sizes[i]),
+            sizes[i] * LevelFile::BytesPerColumn / 1e6, result.writeSeconds, Frames, result.walkSeconds,
+            result.changed / result.walkSeconds, static_cast<unsigned long long>(result.residentChunks));
+        printf("  rss: baseline %.1f MB, peak %.1f MB, grew %.2f MB\n", result.baseline / 1e6, result.peak / 1e6,
+            growth[i] / 1e6);
+    }
+
+    size_t allowed = growth[0] + (sizes[1] - sizes[0]) * LevelFile::BytesPerColumn / 16;
+    if(growth[1] > allowed)
+    {
+        printf("  the longer level grew %.2f MB, at most %.2f MB allowed\n", growth[1] / 1e6, allowed / 1e6);
+        fail("resident memory grows with the level length");
+    }
+
+    if(!rejectsDamaged(path))
+    {
+        fail("a damaged level file was opened");
+    }
+}
@@ -0,0 +1,203 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "terrain.h"
+#include "terraincolumns.h"
+#include "gameworld.h"
+
+namespace
+{
+    /*
+     * The displacement as the screen shader computed it for every pixel before
+     * it was moved to TerrainColumns, transcribed from the GLSL: u_map is
+     * sampled with GL_LINEAR and GL_REPEAT over four level units.
+     */
+    float shaderDisplacement(const TerrainColumns::Input& input, float x)
+    {
+        const float u = x / 4.0f;
+        const float texel = u * input.mapColumns - 0.5f;
+        const float t0 = std::floor(texel);
+        const float f = texel - t0;
+        const long long columns = static_cast<long long>(input.mapColumns);
+        const long long i0 = ((static_cast<long long>(t0) % columns) + columns) % columns;
+        const long long i1 = (i0 + 1) % columns;
+        const unsigned char* a = input.map + i0 * input.mapStride;
+        const unsigned char* b = input.map + i1 * input.mapStride;
+        const float r = (a[0] * (1.0f - f) + b[0] * f) / 255.0f;
+        const float blue = (a[2] * (1.0f - f) + b[2] * f) / 255.0f;
+
+        const float frequencies[3] = {2.0f, 4.0f, 0.5f};
+        const float amplitudes[3] = {0.002f, 0.001f, 0.003f};
+        const float phases[3] = {0.0f, 1.0f, 0.5f};
+        float wave = 0.0f;
+        for(int j = 0; j < 3; ++j)
+        {
+            wave += amplitudes[j]
+                * std::sin(frequencies[j] * 12.0f * x * 2.0f * 3.14159265358979f + phases[j] * input.time * 16.0f);
+        }
+
+        float y = 0.0f;
+        y += std::sin(x * 64.0f * std::cos(27.0f * x) * input.shake) * 0.01f * input.shake;
+        y -= r - 0.5f;
+        y += wave * blue;
+        return y;
+    }
+}
+
+/*
+ * The per-column displacement pass against the shader's old per-pixel
+ * evaluation, both for time and for agreement with it.
+ */
+void bench::terrain()
+{
+    static const glm::ivec2 resolution{1440, 800};
+    static const int frames{200};
+    static const int mapWidth{512};
+
+    std::vector<unsigned char> map(mapWidth * GameWorld::MapStride, 0);
+    for(int i = 0; i < mapWidth; ++i)
+    {
+        map[i * GameWorld::MapStride + 0] = static_cast<unsigned char>(128 + 40 * std::sin(i * 0.05f));
+        map[i * GameWorld::MapStride + 2] = i % 3 == 0 ? 0xFF : 0x00;
+    }
+
+    TerrainColumns::Input input;
+    input.width = resolution.x;
+    input.aspect = static_cast<float>(resolution.x) / resolution.y;
+    input.shake = 0.3f;
+    input.map = map.data();
+    input.mapColumns = mapWidth;
+
+    TerrainColumns columns;
+    auto start = Clock::now();
+    for(int frame = 0; frame < frames; ++frame)
+    {
+        input.time = frame * GameWorld::FixedTimestep;
+        columns.build(input);
+        consume(columns[0]);
+    }
+    double perColumn = secondsSince(start) / frames;
+
+    // What the shader did before: the same evaluation for every pixel.
+    float sum{0.0f};
+    start = Clock::now();
+    for(int frame = 0; frame < frames / 20; ++frame)
+    {
+        input.time = frame * GameWorld::FixedTimestep;
+        for(int row = 0; row < resolution.y; ++row)
+        {
+            for(int column = 0; column < resolution.x; ++column)
+            {
+                float x = (column + 0.5f) / resolution.x * input.aspect - 0.5f + input.camera;
+                sum += shaderDisplacement(input, x);
+            }
+        }
+    }
+    double perPixel = secondsSince(start) / (frames / 20);
+    consume(sum);
+
+    // Float rounding differs a little between the two; the line is 0.006 thick.
+    static const float tolerance{1e-4f};
+    float worst{0.0f};
+    for(int frame = 0; frame < frames; frame += 20)
+    {
+        input.time = frame * GameWorld::FixedTimestep;
+        input.camera = frame * 0.37f;
+        columns.build(input);
+        for(int column = 0; column < resolution.x; ++column)
+        {
+            float x = (column + 0.5f) / resolution.x * input.aspect - 0.5f + input.camera;
+            worst = std::max(worst, std::abs(columns[column] - shaderDisplacement(input, x)));
+        }
+    }
+
+    printf("%dx%d: per column %.1f us/frame, per pixel %.1f us/frame (%.0fx), off by %.2g at most\n", resolution.x,
+        resolution.y, perColumn * 1e6, perPixel * 1e6, perPixel / perColumn, worst);
+    if(!(worst <= tolerance))
+    {
+        fail("column displacement differs from the per-pixel shader");
+    }
+}
+
+/*
+ * Terrain queries the way gameplay makes them: scattered over a stretch of
+ * level around a camera that walks from one end to the other. Batched heights
+ * must match single ones, and waterBetween must match scanning the columns.
+ */
+void bench::queries()
+{
+    static const size_t columns{size_t{1} << 20};
+    static const size_t window{size_t{1} << 15};
+    static const size_t count{size_t{1} << 16};
+    static const int rounds{200};
+    static const float columnsPerUnit{128.0f};
+    static const float span{0.25f};
+
+    std::vector<unsigned char> map(columns * GameWorld::MapStride, 0);
+    for(size_t i = 0; i < columns; ++i)
+    {
+        map[i * GameWorld::MapStride + 0] = static_cast<unsigned char>(128 + 40 * std::sin(i * 0.05f));
+        map[i * GameWorld::MapStride + 2] = i % 97 < 5 ? 0xFF : 0x00;
+    }
+    Terrain terrain;
+    terrain.build(map.data(), columns, GameWorld::MapStride, columnsPerUnit);
+
+    std::vector<float> xs(count);
+    std::vector<float> batched(count);
+    std::vector<float> scalar(count);
+    double scalarSeconds{0.0};
+    double batchedSeconds{0.0};
+    double waterSeconds{0.0};
+    size_t mismatches{0};
+    for(int round = 0; round < rounds; ++round)
+    {
+        size_t origin = (columns - window) * round / rounds;
+        for(size_t i = 0; i < count; ++i)
+        {
+            xs[i] = (origin + i * 2654435761u % window) / columnsPerUnit - 0.5f;
+        }
+
+        auto start = Clock::now();
+        for(size_t i = 0; i < count; ++i)
+        {
+            scalar[i] = terrain.height(xs[i]);
+        }
+        scalarSeconds += secondsSince(start);
+
+        start = Clock::now();
+        terrain.heights(xs.data(), batched.data(), count);
+        batchedSeconds += secondsSince(start);
+        mismatches += scalar != batched;
+
+        size_t wet{0};
+        start = Clock::now();
+        for(size_t i = 0; i < count; ++i)
+        {
+            wet += terrain.waterBetween(xs[i], xs[i] + span);
+        }
+        waterSeconds += secondsSince(start);
+        consume(wet);
+
+        // A few against scanning the columns themselves.
+        for(size_t i = 0; i < count; i += 512)
+        {
+            bool expected = false;
+            for(size_t c = terrain.column(xs[i]); c <= terrain.column(xs[i] + span); ++c)
+            {
+                expected = expected || terrain.waterColumn(c);
+            }
+            mismatches += terrain.waterBetween(xs[i], xs[i] + span) != expected;
+        }
+    }
+
+    const double queries = static_cast<double>(rounds) * count;
+    printf("%zu columns, %zu water spans per chunk: height %.1f ns, batched %.1f ns, waterBetween %.1f ns%s\n",
+        columns, terrain.water(0).size(), scalarSeconds / queries * 1e9, batchedSeconds / queries * 1e9,
+        waterSeconds / queries * 1e9, mismatches ? " MISMATCH" : "");
+    if(mismatches)
+    {
+        fail("terrain queries disagree");
+    }
+}
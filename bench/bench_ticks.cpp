@@ -0,0 +1,78 @@
+#include "bench.h"
+
+#include <vector>
+#include "gameworld.h"
+
+namespace
+{
+    // A flat level with a water gap every 64 columns, laid out like level.png.
+    std::vector<unsigned char> syntheticMap(int width)
+    {
+        std::vector<unsigned char> bytes(width * GameWorld::MapStride, 0x80);
+        for(int i = 0; i < width; ++i)
+        {
+            bytes[i * GameWorld::MapStride + 2] = (i % 64) == 63 ? 0xFF : 0x00;
+        }
+        return bytes;
+    }
+
+    void populate(GameWorld& world, int count)
+    {
+        world.collectables().reserve(count);
+        world.enemies().reserve(count);
+        for(int i = 0; i < count; ++i)
+        {
+            world.spawnCollectable(glm::vec2(0.4f * i + 1.0f, 0.08f));
+            world.spawnEnemy(glm::vec2(0.7f * i + 0.5f, 0.0f));
+        }
+    }
+
+    // Returns ticks per second for a world with count enemies and collectables.
+    double run(int count, unsigned long long tickCount)
+    {
+        static const int width{512};
+
+        std::vector<unsigned char> map = syntheticMap(width);
+        GameWorld world;
+        world.setMap(map.data(), width);
+        world.setGodMode(true);
+        populate(world, count);
+
+        GameWorld::Input input;
+        auto start = bench::Clock::now();
+        for(unsigned long long tick = 0; tick < tickCount; ++tick)
+        {
+            // Run right, hop every second and fire every quarter second.
+            input.right = (tick / 600) % 4 != 3;
+            input.left = !input.right;
+            input.jump = tick % 120 == 0;
+            if(tick % 30 == 0)
+            {
+                world.fire();
+            }
+            world.step(GameWorld::FixedTimestep, input);
+        }
+        double elapsed = bench::secondsSince(start);
+        bench::consume(world.playerPos());
+        return tickCount / elapsed;
+    }
+}
+
+void bench::ticks()
+{
+    static const unsigned long long tickCount{5000000};
+    double rate = run(10, tickCount);
+    printf("%llu ticks: %.0f ticks/s (%.0fx real time)\n", tickCount, rate,
+        rate * GameWorld::FixedTimestep);
+}
+
+void bench::entities()
+{
+    for(int count : {10, 1000, 100000})
+    {
+        unsigned long long tickCount = 50000000ull / (count + 100);
+        double rate = run(count, tickCount);
+        printf("%6d enemies + %6d collectables: %10.0f ticks/s, %6.2f ns/entity\n",
+            count, count, rate, 1e9 / (rate * count * 2));
+    }
+}
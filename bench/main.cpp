@@ -0,0 +1,106 @@
+#include "bench.h"
+
+#include <cstring>
+#include <vector>
+#include "spawntable.h"
+
+#ifndef SUSJAM23_SOURCE_DIR
+#define SUSJAM23_SOURCE_DIR "."
+#endif
+
+namespace
+{
+    int failures{0};
+
+    struct Entry
+    {
+        const char* name;
+        void (*run)();
+    };
+
+    const Entry benchmarks[] = {
+        {"ticks", bench::ticks},
+        {"entities", bench::entities},
+        {"broadphase", bench::broadphase},
+        {"bins", bench::bins},
+        {"render", bench::render},
+        {"terrain", bench::terrain},
+        {"stream", bench::stream},
+        {"editor", bench::editor},
+        {"queries", bench::queries},
+        {"replay", bench::replay},
+        {"profiler", bench::profiler},
+        {"simthread", bench::simthread},
+        {"drs", bench::drs},
+        {"rewind", bench::rewind},
+        {"batch", bench::batch},
+        {"latency", bench::latency},
+        {"allocs", bench::allocs},
+        {"save", bench::save},
+        {"startup", bench::startup},
+        {"chase", bench::chase},
+        {"regions", bench::regions},
+        {"spawns", bench::spawns},
+        {"particles", bench::particles},
+    };
+}
+
+std::string bench::sourceFile(const char* name)
+{
+    return std::string(SUSJAM23_SOURCE_DIR) + "/" + name;
+}
+
+const SpawnTable& bench::levelSpawns()
+{
+    static SpawnTable table;
+    static bool loaded{false};
+    if(!loaded)
+    {
+        // The same list the build compiles into level.png.spawns.
+        loaded = true;
+        std::vector<SpawnTable::Spawn> spawns;
+        int line{0};
+        if(!SpawnTable::parse(sourceFile("level.spawns.txt"), spawns, line))
+        {
+            printf("level.spawns.txt: line %d unreadable\n", line);
+            fail("level spawns not loaded");
+        }
+        table.assign(spawns);
+    }
+    return table;
+}
+
+void bench::fail(const char* reason)
+{
+    printf("FAILED: %s\n", reason);
+    ++failures;
+}
+
+int main(int argc, const char* argv[])
+{
+    int ran{0};
+    for(const auto& b : benchmarks)
+    {
+        bool selected = argc < 2;
+        for(int i = 1; i < argc; ++i)
+        {
+            selected = selected || strcmp(argv[i], b.name) == 0;
+        }
+        if(selected)
+        {
+            printf("== %s\n", b.name);
+            b.run();
+            ++ran;
+        }
+    }
+    if(ran == 0)
+    {
+        fprintf(stderr, "usage: %s [benchmark...]\n", argv[0]);
+        for(const auto& b : benchmarks)
+        {
+            fprintf(stderr, "  %s\n", b.name);
+        }
+        return 1;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "entitypool.h"
+
+/*
+ * Which parts of the level are simulated. The level is cut into regions of
+ * RegionColumns map columns, and the regions within radius() world units of
+ * the camera are awake. Entities that end a tick outside them are put to
+ * sleep behind the awake ones in their pool and linked into a list for their
+ * region, so a tick costs what is near the camera rather than what the level
+ * holds, and a region coming into range wakes only its own sleepers.
+ *
+ * A radius of zero keeps everything awake.
+ */
+class ActivationRegions
+{
+public:
+    static constexpr size_t RegionColumns{256};
+
+    /* The screen spans about two units from the camera; keep a screen of margin. */
+    static constexpr float DefaultRadius{2.0f};
+
+    /*
+     * The sleepers of one pool, one list per region, linked through
+     * EntityInfo::nextSleeper. Sleeping entities must not be despawned.
+     */
+    class Sleepers
+    {
+    public:
+        static constexpr uint32_t End{UINT32_MAX};
+
+        void reset(size_t regions)
+        {
+            _heads.assign(regions, End);
+        }
+
+        template <typename State>
+        void sleep(EntityPool<State>& pool, size_t index, size_t region, float time)
+        {
+            EntityInfo& info = pool.infos()[index];
+            info.sleptAt = time;
+            info.nextSleeper = _heads[region];
+            _heads[region] = pool.handles()[index];
+            pool.sleep(index);
+        }
+
+        /* Wakes every sleeper of region, calling woken(index) for each. */
+        template <typename State, typename Woken>
+        void wake(EntityPool<State>& pool, size_t region, Woken&& woken)
+        {
+            uint32_t handle = _heads[region];
+            _heads[region] = End;
+            while(handle != End)
+            {
+                size_t index = pool.wake(pool.indexOf(handle));
+                handle = pool.infos()[index].nextSleeper;
+                woken(index);
+            }
+        }
+
+        /* Relinks the sleepers of pool from scratch, after it was loaded. */
+        template <typename State>
+        void rebuild(EntityPool<State>& pool, const ActivationRegions& regions)
+        {
+            reset(regions.regions());
+            for(size_t i = pool.awake(); i < pool.size(); ++i)
+            {
+                size_t region = regions.region(pool.positions()[i].x);
+                pool.infos()[i].nextSleeper = _heads[region];
+                _heads[region] = pool.handles()[i];
+            }
+        }
+
+    private:
+        std::vector<uint32_t> _heads;
+    };
+
+    void setMap(size_t columns, float columnsPerUnit);
+
+    void setRadius(float radius)
+    {
+        _radius = radius;
+    }
+
+    float radius() const
+    {
+        return _radius;
+    }
+
+    /* At least one, so there is always a region to be in. */
+    size_t regions() const
+    {
+        return _regions;
+    }
+
+    /* The region x falls in; positions off either end of the map count as its end regions. */
+    size_t region(float x) const;
+
+    /* The awake regions are [first(), last()], once update() has run. */
+    size_t first() const
+    {
+        return _first;
+    }
+
+    size_t last() const
+    {
+        return _last;
+    }
+
+    bool awake(size_t region) const
+    {
+        return region >= _first && region <= _last;
+    }
+
+    /* Moves the awake range to the camera and calls woken(region) for every region it gained. */
+    template <typename Woken>
+    void update(float cameraX, Woken&& woken)
+    {
+        size_t first, last;
+        range(cameraX, first, last);
+        for(size_t r = first; r <= last; ++r)
+        {
+            if(!awake(r))
+            {
+                woken(r);
+            }
+        }
+        _first = first;
+        _last = last;
+    }
+
+    /* Sets the awake range without waking anything, after a state load. */
+    void place(float cameraX)
+    {
+        range(cameraX, _first, _last);
+    }
+
+private:
+    void range(float cameraX, size_t& first, size_t& last) const;
+
+    size_t _columns{0};
+    double _columnsPerUnit{0.0};
+    size_t _regions{1};
+    float _radius{DefaultRadius};
+    /* Nothing is awake before the first update. */
+    size_t _first{1};
+    size_t _last{0};
+};
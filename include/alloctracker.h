@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Counts heap allocations per thread by replacing the global operator new
+ * and delete. The hooks are only compiled in with SUSJAM23_ALLOC_TRACKING,
+ * which the SUSJAM23_ALLOC_TRACKING CMake option defines; otherwise every
+ * count reads zero and nothing is replaced. The hooks sit in the same object
+ * file as thread(), so anything using the tracker links them in from the
+ * core library.
+ *
+ * Frames is the per-frame view: call frame() once at each frame boundary on
+ * the thread that runs the frame, and after the warm-up frames it keeps track
+ * of any frame that allocated at all.
+ */
+class AllocTracker
+{
+public:
+#ifdef SUSJAM23_ALLOC_TRACKING
+    static constexpr bool Enabled{true};
+#else
+    static constexpr bool Enabled{false};
+#endif
+
+    struct Counts
+    {
+        uint64_t allocations{0};
+        uint64_t bytes{0};
+        uint64_t frees{0};
+
+        Counts operator-(const Counts& other) const
+        {
+            return Counts{allocations - other.allocations, bytes - other.bytes, frees - other.frees};
+        }
+    };
+
+    /* Totals for the calling thread since it started. */
+    static Counts thread();
+
+    class Frames
+    {
+    public:
+        explicit Frames(int warmupFrames) : _warmupFrames{warmupFrames}
+        {
+        }
+
+        /* Ends the current frame and starts the next. Returns the ended frame's counts. */
+        const Counts& frame();
+
+        const Counts& last() const
+        {
+            return _last;
+        }
+
+        /* Frames after warm-up that allocated. */
+        uint64_t allocatingFrames() const
+        {
+            return _allocatingFrames;
+        }
+
+        /* The most allocations any frame after warm-up made. */
+        const Counts& worst() const
+        {
+            return _worst;
+        }
+
+        bool steady() const
+        {
+            return _frames > static_cast<uint64_t>(_warmupFrames);
+        }
+
+    private:
+        int _warmupFrames;
+        uint64_t _frames{0};
+        uint64_t _allocatingFrames{0};
+        Counts _start{thread()};
+        Counts _last;
+        Counts _worst;
+    };
+};
@@ -3,11 +3,51 @@
 #include "glapplication.h"
 #include "pipeline.h"
 #include "glmesh.h"
+#include "gameworld.h"
+#include "entityuniforms.h"
+#include "columnbins.h"
+#include "terraincolumns.h"
+#include "buffertexture.h"
+#include "levelfile.h"
+#include "levelimage.h"
+#include "mapeditor.h"
+#include "mapsaver.h"
+#include "spawntable.h"
+#include "inputlog.h"
+#include "profiler.h"
+#include "alloctracker.h"
+#include "simulationthread.h"
+#include "startuploader.h"
 
 class App : public lithium::Application
 {
 public:
-    App();
+    /*
+     * What App reads from disk. start() hands the loading to startup's
+     * threads, so it runs while the window and GL context are created.
+     */
+    struct Assets
+    {
+        std::string levelPath;
+        /* The compiled level at levelPath, or level.png without one. */
+        std::shared_ptr<LevelFile> level;
+        std::shared_ptr<LevelImage> image;
+        /* The level's spawn table, if it has one. */
+        std::shared_ptr<SpawnTable> spawns;
+        std::string screenFragment;
+        StartupLoader::Task levelTask{0};
+        StartupLoader::Task shaderTask{0};
+
+        void start(StartupLoader& startup, const std::string& path);
+    };
+
+    /*
+     * Plays level.png, or a compiled level when assets were started with a
+     * path. With a record path the session's inputs are written there on
+     * exit, for susjam23_replay. Joins each asset task right before its first
+     * use, and prints the startup breakdown after the first frame.
+     */
+    App(StartupLoader& startup, Assets& assets, const std::string& recordPath = "");
 
     virtual ~App() noexcept;
 
@@ -18,7 +58,10 @@ public:
 protected:
     virtual void onFpsCount(int fps) override
     {
-        //printf("FPS: %d\n", fps);
+#ifdef SUSJAM23_PROFILE
+        printf("FPS: %d\n", fps);
+        Profiler::printSummary(stdout);
+#endif
     }
 
     bool manipMap(int mods, int amount, int bit);
@@ -27,59 +70,39 @@ private:
     std::shared_ptr<Pipeline> _pipeline{nullptr};
     std::vector<std::shared_ptr<lithium::Object>> _objects;
     std::shared_ptr<lithium::Object> _background;
-    std::shared_ptr<lithium::ImageTexture> _map;
+    /* Startup phases, until the first frame is done. */
+    StartupLoader* _startup{nullptr};
+    std::shared_ptr<LevelImage> _map;
+    /*
+     * The simulation's copy of an editable map. Edits land in _map on this
+     * thread and reach the copy as posted jobs, so neither side reads bytes
+     * the other is writing.
+     */
+    std::vector<unsigned char> _worldMap;
+    std::shared_ptr<LevelFile> _level;
+    std::shared_ptr<SpawnTable> _spawns;
+    MapEditor _mapEditor;
+    MapSaver _mapSaver;
+    /* Alt+S; saved after this frame's edits are flushed. */
+    bool _saveRequested{false};
     float _cameraYaw{0.0f};
     float _cameraPitch{0.0f};
     glm::vec3 _cameraTarget{0.0f};
     std::shared_ptr<lithium::Input::KeyCache> _keyCache;
 
-    glm::vec3 _playerPos{-0.5f, 0.0f, 0.0f};
-    glm::vec2 _playerVel{0.0f, 0.0f};
-
-    glm::vec2 _camera2d{0.0f, 0.0f};
-
-    bool _playerCrawling{false};
-    
-    enum class JumpState
-    {
-        GROUNDED,
-        JUMPING,
-        FALLING
-    } _playerJumpState{JumpState::GROUNDED};
-
-    struct Projectile
-    {
-        glm::vec2 position;
-        glm::vec2 velocity;
-        bool used{false};
-        bool inactive{false};
-    };
-
-    struct Collectable
-    {
-        glm::vec2 position;
-        bool used{false};
-        bool inactive{false};
-        bool picked{false};
-        float picking{0.0f};
-    };
-
-    struct Enemy
-    {
-        glm::vec2 position;
-        bool used{false};
-        bool inactive{false};
-        bool facingLeft{false};
-        bool chasingPlayer{false};
-        float deathTimer{0.0f};
-        int health{1};
-    };
-
-    Projectile _playerProjectiles[10];
-    Collectable _collectables[10];
-    Enemy _enemies[10];
-    bool _godMode{false};
-
-    float _shakeTimer{0.0f};
-    float _shake{0.0f};
+    GameWorld _world;
+    InputLog _inputLog;
+    std::string _recordPath;
+    uint64_t _recordSeed{0};
+    RewindBuffer _rewind;
+    /* Declared after the world and the rewind buffer so it stops before the world goes away. */
+    SimulationThread _simulation{_world};
+    WorldSnapshot _snapshot;
+    /* Main thread frames; the first few seconds may allocate. */
+    AllocTracker::Frames _frameAllocations{600};
+    EntityUniforms _entityUniforms;
+    ColumnBins _columnBins;
+    std::shared_ptr<BufferTexture> _binTexture;
+    TerrainColumns _terrainColumns;
+    std::shared_ptr<BufferTexture> _terrainTexture;
 };
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "gameworld.h"
+#include "random.h"
+#include "threadpool.h"
+
+/*
+ * Plays one level many times over without a window, each instance a separate
+ * GameWorld driven by a bot, spread over a thread pool. Used to check edited
+ * levels can still be finished and how often the player runs into water or
+ * enemies on the way.
+ *
+ * An instance completes when the player reaches the end of the map within
+ * maxTicks. The jam game has no player death, so water and enemy hits are
+ * reported as counts instead.
+ */
+class BatchRunner
+{
+public:
+    enum class Bot
+    {
+        /* Holds right and jumps or fires at hazards ahead, with per-instance reaction distances. */
+        RUNNER,
+        /* Random held buttons, biased to the right, re-rolled every half second or so. */
+        RANDOM
+    };
+
+    struct Config
+    {
+        int instances{256};
+        unsigned long long maxTicks{static_cast<unsigned long long>(180.0f / GameWorld::FixedTimestep)};
+        Bot bot{Bot::RUNNER};
+        uint64_t seed{1};
+        /* Shared read-only by every instance; none for an empty level. */
+        const SpawnTable* spawns{nullptr};
+    };
+
+    struct Result
+    {
+        bool completed{false};
+        unsigned long long ticks{0};
+        float reachedX{0.0f};
+        GameWorld::Counters counters;
+    };
+
+    struct Report
+    {
+        int instances{0};
+        int completed{0};
+        unsigned long long ticks{0};
+        unsigned long long waterHits{0};
+        unsigned long long enemyHits{0};
+        unsigned long long collected{0};
+        double seconds{0.0};
+        unsigned threads{0};
+
+        double ticksPerSecond() const
+        {
+            return seconds > 0.0 ? ticks / seconds : 0.0;
+        }
+
+        double ticksPerSecondPerThread() const
+        {
+            return threads ? ticksPerSecond() / threads : 0.0;
+        }
+    };
+
+    explicit BatchRunner(std::shared_ptr<ThreadPool> threadPool = nullptr);
+
+    /* The map is shared read-only by every instance. */
+    Report run(const unsigned char* map, size_t columns, float columnsPerUnit, const Config& config);
+
+    /* Per-instance outcomes of the last run, in instance order. */
+    const std::vector<Result>& results() const
+    {
+        return _results;
+    }
+
+    static Result play(const unsigned char* map, size_t columns, float columnsPerUnit, const Config& config, int instance);
+
+private:
+    std::shared_ptr<ThreadPool> _threadPool;
+    std::vector<Result> _results;
+};
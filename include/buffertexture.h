@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include "glshaderprogram.h"
+
+/*
+ * A buffer texture streamed from the CPU every frame and read in the screen
+ * shader with texelFetch. The storage grows by doubling and is reused from
+ * frame to frame.
+ */
+class BufferTexture
+{
+public:
+    explicit BufferTexture(GLenum internalFormat);
+
+    ~BufferTexture() noexcept;
+
+    void upload(const void* data, size_t size);
+
+    template <typename T>
+    void upload(const std::vector<T>& values)
+    {
+        upload(values.data(), values.size() * sizeof(T));
+    }
+
+    void bind(GLenum textureUnit);
+
+    size_t bytesUploaded() const
+    {
+        return _bytesUploaded;
+    }
+
+private:
+    GLenum _internalFormat;
+    GLuint _buffer{0};
+    GLuint _texture{0};
+    size_t _capacity{0};
+    size_t _bytesUploaded{0};
+};
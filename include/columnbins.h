@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+#include "worldsnapshot.h"
+
+/*
+ * Sorts the entities of a snapshot into buckets of screen columns so the screen shader
+ * only visits entities that can touch the pixel it is shading.
+ *
+ * The result is one flat texel array, uploaded as an RGBA32F texture buffer.
+ * The first binCount() texels are headers (first item, item count). Items
+ * follow, one texel each: (x, y, deathTimer, flags), where the low two bits
+ * of flags hold the Type and the rest hold the enemy flags or, for particles,
+ * the ParticleSystem::Kind. Particles carry their fade in place of the death
+ * timer. Within a bin the items keep the order the shader used to loop in:
+ * projectiles, enemies, then collectables, each in pool order, with particles
+ * last.
+ */
+class ColumnBins
+{
+public:
+    enum Type
+    {
+        PROJECTILE = 0,
+        ENEMY = 1,
+        COLLECTABLE = 2,
+        PARTICLE = 3
+    };
+
+    static constexpr int ChasingFlag{4};
+    static constexpr int FacingLeftFlag{8};
+    static constexpr int ParticleKindShift{2};
+
+    /* Widest reach of each type along x in the shader, in screen units. */
+    static constexpr float ProjectileRadius{0.05f};
+    static constexpr float EnemyRadius{0.05f};
+    static constexpr float CollectableRadius{0.0116f};
+    static constexpr float ParticleRadius{0.004f};
+
+    struct Texel
+    {
+        float x;
+        float y;
+        float z;
+        float w;
+    };
+
+    /*
+     * Bins the world for a screen of the given aspect ratio. The visible range
+     * of st.x in the shader is [camera.x - 0.5, camera.x - 0.5 + aspect].
+     */
+    void build(const WorldSnapshot& world, float aspect, int binCount);
+
+    int binOf(float x) const;
+
+    int binCount() const
+    {
+        return _binCount;
+    }
+
+    float origin() const
+    {
+        return _origin;
+    }
+
+    float binWidth() const
+    {
+        return _binWidth;
+    }
+
+    int first(int bin) const
+    {
+        return static_cast<int>(_texels[bin].x);
+    }
+
+    int count(int bin) const
+    {
+        return static_cast<int>(_texels[bin].y);
+    }
+
+    const Texel& item(int index) const
+    {
+        return _texels[index];
+    }
+
+    const std::vector<Texel>& texels() const
+    {
+        return _texels;
+    }
+
+private:
+    template <typename Visitor>
+    void forEachItem(const WorldSnapshot& world, Visitor&& visit) const;
+
+    void range(float x, float radius, int& begin, int& end) const;
+
+    int _binCount{0};
+    float _origin{0.0f};
+    float _binWidth{1.0f};
+    std::vector<Texel> _texels;
+    std::vector<int> _cursor;
+};
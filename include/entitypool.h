@@ -0,0 +1,309 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+/*
+ * Cold per-entity data, written at spawn and rarely read by the update loops.
+ */
+struct EntityInfo
+{
+    static constexpr uint32_t NoEntry{UINT32_MAX};
+
+    glm::vec2 origin{0.0f};
+    unsigned long long spawnTick{0};
+    /* The spawn table entry it was streamed in from, or NoEntry. */
+    uint32_t entry{NoEntry};
+    /* While asleep: when it fell asleep and the next sleeper of its region. */
+    float sleptAt{0.0f};
+    uint32_t nextSleeper{UINT32_MAX};
+};
+
+/*
+ * Structure-of-arrays entity storage. Live entities occupy the dense range
+ * [0, size()) of three parallel arrays: positions, the per-type State and the
+ * cold EntityInfo. Despawning swaps the last entity into the hole, so loops
+ * never see dead slots. Handles stay valid across such moves and are recycled
+ * through a free list.
+ *
+ * Awake entities come first, in [0, awake()); update loops stop there and
+ * never touch the sleeping ones behind them. New entities are awake.
+ */
+template <typename State>
+class EntityPool
+{
+public:
+    using Handle = uint32_t;
+
+    static constexpr Handle InvalidHandle{UINT32_MAX};
+
+    void reserve(size_t capacity)
+    {
+        _positions.reserve(capacity);
+        _states.reserve(capacity);
+        _infos.reserve(capacity);
+        _handles.reserve(capacity);
+        _slots.reserve(capacity);
+        _freeHandles.reserve(capacity);
+    }
+
+    Handle spawn(const glm::vec2& position, const State& state, const EntityInfo& info)
+    {
+        Handle handle;
+        if(_freeHandles.empty())
+        {
+            handle = static_cast<Handle>(_slots.size());
+            _slots.push_back(0);
+            // Every handle can end up on the free list; size it now so
+            // despawning never allocates.
+            _freeHandles.reserve(_slots.capacity());
+        }
+        else
+        {
+            handle = _freeHandles.back();
+            _freeHandles.pop_back();
+        }
+        _slots[handle] = static_cast<uint32_t>(_positions.size());
+        _positions.push_back(position);
+        _states.push_back(state);
+        _infos.push_back(info);
+        _handles.push_back(handle);
+        swap(_positions.size() - 1, _awake++);
+        return handle;
+    }
+
+    void despawn(Handle handle)
+    {
+        removeAt(_slots[handle]);
+    }
+
+    /*
+     * Removes the entity at a dense index. The last entity takes its place, or
+     * for an awake one the last awake entity, whose place the last one takes.
+     */
+    void removeAt(size_t index)
+    {
+        Handle removed = _handles[index];
+        if(index < _awake)
+        {
+            move(--_awake, index);
+            index = _awake;
+        }
+        move(_positions.size() - 1, index);
+        _positions.pop_back();
+        _states.pop_back();
+        _infos.pop_back();
+        _handles.pop_back();
+        _slots[removed] = InvalidSlot;
+        _freeHandles.push_back(removed);
+    }
+
+    void clear()
+    {
+        while(!_positions.empty())
+        {
+            removeAt(_positions.size() - 1);
+        }
+    }
+
+    bool alive(Handle handle) const
+    {
+        return handle < _slots.size() && _slots[handle] != InvalidSlot;
+    }
+
+    size_t indexOf(Handle handle) const
+    {
+        return _slots[handle];
+    }
+
+    size_t size() const
+    {
+        return _positions.size();
+    }
+
+    /* Entities that fit before the arrays grow. */
+    size_t capacity() const
+    {
+        return _positions.capacity();
+    }
+
+    size_t awake() const
+    {
+        return _awake;
+    }
+
+    /* Puts the awake entity at index to sleep. The last awake entity takes its place. */
+    void sleep(size_t index)
+    {
+        swap(index, --_awake);
+    }
+
+    /* Wakes the sleeping entity at index and returns where it is now. */
+    size_t wake(size_t index)
+    {
+        swap(index, _awake);
+        return _awake++;
+    }
+
+    void wakeAll()
+    {
+        _awake = _positions.size();
+    }
+
+    bool empty() const
+    {
+        return _positions.empty();
+    }
+
+    glm::vec2* positions()
+    {
+        return _positions.data();
+    }
+
+    const glm::vec2* positions() const
+    {
+        return _positions.data();
+    }
+
+    State* states()
+    {
+        return _states.data();
+    }
+
+    const State* states() const
+    {
+        return _states.data();
+    }
+
+    EntityInfo* infos()
+    {
+        return _infos.data();
+    }
+
+    const EntityInfo* infos() const
+    {
+        return _infos.data();
+    }
+
+    const Handle* handles() const
+    {
+        return _handles.data();
+    }
+
+    /*
+     * Appends the pool, free list included, to out as raw bytes. read() takes
+     * them back so handles resolve exactly as before. State must be trivially
+     * copyable.
+     */
+    void write(std::vector<unsigned char>& out) const
+    {
+        uint32_t awake = static_cast<uint32_t>(_awake);
+        size_t offset = out.size();
+        out.resize(offset + sizeof(awake));
+        std::memcpy(out.data() + offset, &awake, sizeof(awake));
+        writeArray(out, _positions);
+        writeArray(out, _states);
+        writeArray(out, _infos);
+        writeArray(out, _handles);
+        writeArray(out, _slots);
+        writeArray(out, _freeHandles);
+    }
+
+    /* Advances data past what write() produced; false if it runs past end. */
+    bool read(const unsigned char*& data, const unsigned char* end)
+    {
+        uint32_t awake;
+        if(static_cast<size_t>(end - data) < sizeof(awake))
+        {
+            return false;
+        }
+        std::memcpy(&awake, data, sizeof(awake));
+        data += sizeof(awake);
+        _awake = awake;
+        return readArray(data, end, _positions)
+            && readArray(data, end, _states)
+            && readArray(data, end, _infos)
+            && readArray(data, end, _handles)
+            && readArray(data, end, _slots)
+            && readArray(data, end, _freeHandles)
+            && _awake <= _positions.size();
+    }
+
+private:
+    static constexpr uint32_t InvalidSlot{UINT32_MAX};
+
+    /* Copies the entity at from over the one at to. */
+    void move(size_t from, size_t to)
+    {
+        if(from == to)
+        {
+            return;
+        }
+        _positions[to] = _positions[from];
+        _states[to] = _states[from];
+        _infos[to] = _infos[from];
+        _handles[to] = _handles[from];
+        _slots[_handles[to]] = static_cast<uint32_t>(to);
+    }
+
+    void swap(size_t a, size_t b)
+    {
+        if(a == b)
+        {
+            return;
+        }
+        std::swap(_positions[a], _positions[b]);
+        std::swap(_states[a], _states[b]);
+        std::swap(_infos[a], _infos[b]);
+        std::swap(_handles[a], _handles[b]);
+        _slots[_handles[a]] = static_cast<uint32_t>(a);
+        _slots[_handles[b]] = static_cast<uint32_t>(b);
+    }
+
+    template <typename T>
+    static void writeArray(std::vector<unsigned char>& out, const std::vector<T>& values)
+    {
+        uint32_t count = static_cast<uint32_t>(values.size());
+        size_t offset = out.size();
+        out.resize(offset + sizeof(count) + count * sizeof(T));
+        std::memcpy(out.data() + offset, &count, sizeof(count));
+        if(count)
+        {
+            std::memcpy(out.data() + offset + sizeof(count), values.data(), count * sizeof(T));
+        }
+    }
+
+    template <typename T>
+    static bool readArray(const unsigned char*& data, const unsigned char* end, std::vector<T>& values)
+    {
+        uint32_t count;
+        if(static_cast<size_t>(end - data) < sizeof(count))
+        {
+            return false;
+        }
+        std::memcpy(&count, data, sizeof(count));
+        data += sizeof(count);
+        if(static_cast<size_t>(end - data) / sizeof(T) < count)
+        {
+            return false;
+        }
+        values.resize(count);
+        if(count)
+        {
+            std::memcpy(values.data(), data, count * sizeof(T));
+        }
+        data += count * sizeof(T);
+        return true;
+    }
+
+    std::vector<glm::vec2> _positions;
+    std::vector<State> _states;
+    std::vector<EntityInfo> _infos;
+    std::vector<Handle> _handles;
+    std::vector<uint32_t> _slots;
+    std::vector<Handle> _freeHandles;
+    size_t _awake{0};
+};
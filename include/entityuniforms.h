@@ -0,0 +1,64 @@
+#pragma once
+
+#include "glshaderprogram.h"
+#include "worldsnapshot.h"
+#include "columnbins.h"
+#include "frameuniforms.h"
+
+/*
+ * Uploads the world state the screen shader reads. The per-frame values live
+ * in one std140 uniform block, Frame, whose layout is FrameUniforms. Each
+ * frame packs the snapshot into it and writes the whole block with a single
+ * buffer update, skipped when nothing changed since the last upload.
+ *
+ * Entities and terrain reach the shader through buffer textures; bind() only
+ * points the samplers at their units and the block at its binding point.
+ */
+class EntityUniforms
+{
+public:
+    /* Texture units of the column bins and the terrain columns. */
+    static constexpr int BinTextureUnit{1};
+    static constexpr int TerrainTextureUnit{2};
+    /* Uniform buffer binding point of the Frame block. */
+    static constexpr GLuint FrameBinding{1};
+
+    struct Stats
+    {
+        int uploads{0};
+        int lookups{0};
+    };
+
+    ~EntityUniforms() noexcept;
+
+    bool isBoundTo(lithium::ShaderProgram* shaderProgram) const
+    {
+        return _program == shaderProgram->id();
+    }
+
+    /* Expects the shader program to be in use. */
+    void bind(lithium::ShaderProgram* shaderProgram);
+
+    /* Expects the bound shader program to be in use. */
+    void upload(const WorldSnapshot& world, const ColumnBins& bins, const glm::vec2& resolution, float time);
+
+    /*
+     * Counters for the most recent upload. Lookups only happen in bind(), so
+     * a steady-state frame reports zero lookups and at most one upload.
+     */
+    const Stats& frameStats() const
+    {
+        return _frameStats;
+    }
+
+private:
+    static void pack(const WorldSnapshot& world, const ColumnBins& bins, const glm::vec2& resolution, float time, FrameUniforms& packed);
+
+    GLuint _program{0};
+    GLuint _buffer{0};
+    bool _forceUpload{true};
+    Stats _frameStats;
+
+    FrameUniforms _current{};
+    FrameUniforms _uploaded{};
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "terrain.h"
+
+/*
+ * Chase directions over the level columns toward one target column, shared
+ * by every chasing enemy. Walking from a column to its neighbour is blocked
+ * by water on either side and by climbs higher than MaxStep; drops of any
+ * height are fine.
+ *
+ * The level is a line, so the only path to the target is straight at it and
+ * the field reduces to how far a walker gets going right and going left from
+ * each column. A column reaches the target when its reach covers it, so a
+ * lookup is O(1) however many enemies ask, and an edit only re-derives the
+ * reach of the walkable run around it.
+ *
+ * Chasers are awake enemies near the camera, so the field only covers a
+ * window of WindowColumns around the target and costs the same however long
+ * the level is. Paths inside the window are exact; columns outside it have no
+ * direction. When the target drifts a quarter window from the middle, the
+ * window is moved onto it and re-derived; otherwise moving the target costs
+ * nothing.
+ */
+class FlowField
+{
+public:
+    /* Highest rise between neighbouring columns an enemy walks up, in world units. */
+    static constexpr float MaxStep{0.05f};
+    static constexpr size_t WindowColumns{8 * Terrain::ChunkColumns};
+
+    /* Derives the window around the current target. */
+    void build(const Terrain& terrain);
+
+    /* Re-derives the reach around count columns from first, after terrain.update(). */
+    void update(const Terrain& terrain, size_t first, size_t count);
+
+    /* First column of the window. */
+    size_t begin() const
+    {
+        return _begin;
+    }
+
+    /* One past the last column of the window. */
+    size_t end() const
+    {
+        return _begin + _reach.size();
+    }
+
+    /* Moves the target, and the window with it when the target nears its edge. */
+    void setTarget(const Terrain& terrain, size_t column);
+
+    size_t target() const
+    {
+        return _target;
+    }
+
+    /*
+     * The way to walk from column to reach the target: -1, 0 or +1. Zero at
+     * the target column itself, where the target cannot be reached and
+     * outside the window.
+     */
+    int direction(size_t column) const
+    {
+        if(column < _begin || column >= end())
+        {
+            return 0;
+        }
+        const Reach& reach = _reach[column - _begin];
+        if(column < _target)
+        {
+            return _begin + reach.right >= _target ? 1 : 0;
+        }
+        if(column > _target)
+        {
+            return _begin + reach.left <= _target ? -1 : 0;
+        }
+        return 0;
+    }
+
+    /* Furthest column a walker starting at column gets to going right, within the window. */
+    size_t reachRight(size_t column) const
+    {
+        return _begin + _reach[column - _begin].right;
+    }
+
+    /* Furthest column a walker starting at column gets to going left, within the window. */
+    size_t reachLeft(size_t column) const
+    {
+        return _begin + _reach[column - _begin].left;
+    }
+
+    /* Whether a walker can step from column from to its neighbour to. */
+    static bool passable(const Terrain& terrain, size_t from, size_t to)
+    {
+        return !terrain.waterColumn(from) && !terrain.waterColumn(to)
+            && terrain.columnHeight(to) - terrain.columnHeight(from) <= MaxStep;
+    }
+
+private:
+    /* Side by side, so a lookup touches one cache line. Offsets from _begin. */
+    struct Reach
+    {
+        uint32_t right;
+        uint32_t left;
+    };
+
+    /* Where the window starts when centred on column. */
+    size_t windowFor(size_t column) const;
+
+    std::vector<Reach> _reach;
+    size_t _begin{0};
+    size_t _columns{0};
+    size_t _target{0};
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include "shaderlayout.h"
+
+/*
+ * Everything the screen shader reads once per frame, in the order and padding
+ * of its std140 block. The struct is memcpy'd into the uniform buffer, the
+ * GLSL declaration is generated from FrameFields, and the static_asserts
+ * below keep the two in step: adding a member means adding its field here.
+ */
+struct FrameUniforms
+{
+    glm::vec2 camera;
+    float binOrigin;
+    float binWidth;
+    glm::vec3 playerPos;
+    float shake;
+    glm::vec2 resolution;
+    float time;
+    int binCount;
+};
+
+constexpr std::array<shaderlayout::Field, 8> FrameFields{{
+    shaderlayout::field<glm::vec2>("u_camera", offsetof(FrameUniforms, camera)),
+    shaderlayout::field<float>("u_binOrigin", offsetof(FrameUniforms, binOrigin)),
+    shaderlayout::field<float>("u_binWidth", offsetof(FrameUniforms, binWidth)),
+    shaderlayout::field<glm::vec3>("u_playerPos", offsetof(FrameUniforms, playerPos)),
+    shaderlayout::field<float>("u_shake", offsetof(FrameUniforms, shake)),
+    shaderlayout::field<glm::vec2>("u_resolution", offsetof(FrameUniforms, resolution)),
+    shaderlayout::field<float>("u_time", offsetof(FrameUniforms, time)),
+    shaderlayout::field<int>("u_binCount", offsetof(FrameUniforms, binCount)),
+}};
+
+static_assert(shaderlayout::isStd140(FrameFields), "FrameUniforms does not follow std140");
+static_assert(shaderlayout::blockSize(FrameFields) == sizeof(FrameUniforms), "FrameUniforms is not padded like its std140 block");
+
+/*
+ * GLSL for the Frame block plus the bin item constants shared with
+ * ColumnBins, for pasting in front of the screen shader's body.
+ */
+std::string frameDeclarations();
@@ -0,0 +1,386 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "activationregions.h"
+#include "entitypool.h"
+#include "flowfield.h"
+#include "particlesystem.h"
+#include "spawntable.h"
+#include "sweepindex.h"
+#include "terrain.h"
+#include "random.h"
+
+class InputLog;
+struct WorldSnapshot;
+
+/*
+ * Headless gameplay state and simulation. Owns the player, the entity pools and
+ * the screen shake, and steps them at a fixed timestep without any window or GL
+ * context. App feeds it input and reads it back for rendering.
+ */
+class GameWorld
+{
+public:
+    static constexpr float FixedTimestep{1.0f / 120.0f};
+    static constexpr int MaxStepsPerAdvance{8};
+    static constexpr int MapStride{4};
+    /* level.png spans this many world units, whatever its width. */
+    static constexpr float LegacyLevelUnits{4.0f};
+
+    struct Input
+    {
+        bool left{false};
+        bool right{false};
+        bool jump{false};
+        bool crawl{false};
+        /* One-shot actions, applied on the first step they are seen. */
+        bool fire{false};
+        bool shake{false};
+    };
+
+    enum class JumpState
+    {
+        GROUNDED,
+        JUMPING,
+        FALLING
+    };
+
+    struct Projectile
+    {
+        glm::vec2 velocity{0.0f};
+        /* Terrain height where the shot was fired. */
+        float ground{0.0f};
+    };
+
+    struct Collectable
+    {
+        bool picked{false};
+        float picking{0.0f};
+    };
+
+    struct Enemy
+    {
+        bool facingLeft{false};
+        bool chasingPlayer{false};
+        float deathTimer{0.0f};
+        int health{1};
+    };
+
+    /* Running totals of gameplay events, for bots and level validation. */
+    struct Counters
+    {
+        unsigned waterHits{0};
+        unsigned enemyHits{0};
+        unsigned collected{0};
+        unsigned kills{0};
+    };
+
+    using Projectiles = EntityPool<Projectile>;
+    using Collectables = EntityPool<Collectable>;
+    using Enemies = EntityPool<Enemy>;
+
+    /* Live shots the player may have in flight at once. */
+    static constexpr size_t MaxProjectiles{10};
+
+    /* Effect particles alive at once; bursts past this are cut short. */
+    static constexpr size_t MaxParticles{4096};
+
+    /* Spawns setSpawns() makes room for up front; bigger tables grow the pools as they stream in. */
+    static constexpr size_t MaxReservedSpawns{4096};
+
+    /* Streamed regions kept either side of the awake ones; entities of regions further out are freed. */
+    static constexpr size_t KeptSpawnRegions{8};
+
+    /* Terrain rising this far above a shot's launch height stops it. */
+    static constexpr float ProjectileClearance{0.1f};
+
+    GameWorld();
+
+    /*
+     * The map is one row of RGBA columns where R is height and B is water. The
+     * world does not own the bytes; the editor may change them in place.
+     * Column 0 sits at x = -0.5. A columnsPerUnit of zero stretches the map
+     * over LegacyLevelUnits, like level.png.
+     */
+    void setMap(const unsigned char* bytes, size_t columns, float columnsPerUnit = 0.0f);
+
+    size_t mapColumn(float x) const
+    {
+        return _terrain.column(x);
+    }
+
+    /* Refreshes the terrain after count map columns from first were edited. */
+    void mapChanged(size_t first, size_t count)
+    {
+        _terrain.update(first, count);
+        _flowField.update(_terrain, first, count);
+    }
+
+    const Terrain& terrain() const
+    {
+        return _terrain;
+    }
+
+    /*
+     * Entities further than radius world units from the camera sleep until it
+     * comes near; zero simulates the whole level every step.
+     */
+    void setActivationRadius(float radius)
+    {
+        _activation.setRadius(radius);
+    }
+
+    const ActivationRegions& activation() const
+    {
+        return _activation;
+    }
+
+    /* Chase directions toward the player's column as of the last step. */
+    const FlowField& flowField() const
+    {
+        return _flowField;
+    }
+
+    const unsigned char* mapBytes() const
+    {
+        return _mapBytes;
+    }
+
+    size_t mapColumns() const
+    {
+        return _mapColumns;
+    }
+
+    float columnsPerUnit() const
+    {
+        return _columnsPerUnit;
+    }
+
+    Collectables::Handle spawnCollectable(const glm::vec2& position);
+
+    Enemies::Handle spawnEnemy(const glm::vec2& position);
+
+    Projectiles::Handle fire();
+
+    /*
+     * The level's collectables and enemies, spawned a region at a time as the
+     * camera first comes near. Once the camera is KeptSpawnRegions past a
+     * region, the entities that came from it are freed as they sleep and it
+     * starts over from the table if the camera comes back, so the pools hold
+     * what is near rather than everything passed. One still awake, like a
+     * chaser in tow, is not spawned again. The world does not own the table. Set it before
+     * the first step.
+     */
+    void setSpawns(const SpawnTable* spawns);
+
+    /* Seeds the gameplay random generator; sessions with the same seed and inputs match. */
+    void setSeed(uint64_t seed)
+    {
+        _random.setSeed(seed);
+    }
+
+    /* Inputs are appended to log every step while it is set. */
+    void setRecorder(InputLog* log)
+    {
+        _recorder = log;
+    }
+
+    /* Copies the state rendering needs into out, reusing its storage. */
+    void snapshot(WorldSnapshot& out) const;
+
+    /*
+     * Appends everything a step reads or writes, except the map, to out.
+     * loadState() puts the world back exactly as it was when saved; it
+     * returns false and leaves the world unspecified on truncated data.
+     */
+    void saveState(std::vector<unsigned char>& out) const;
+
+    bool loadState(const unsigned char* data, size_t size);
+
+    /* FNV-1a over the simulation state, for checking replays. */
+    uint64_t stateHash() const;
+
+    /*
+     * Accumulates dt and runs as many fixed steps as fit. Returns the number of
+     * steps taken. Time that does not fit is carried to the next call.
+     */
+    int advance(float dt, const Input& input);
+
+    void step(float dt, const Input& input);
+
+    /* Fraction of a fixed step left in the accumulator, for interpolation. */
+    float alpha() const
+    {
+        return _accumulator / FixedTimestep;
+    }
+
+    float time() const
+    {
+        return _time;
+    }
+
+    unsigned long long ticks() const
+    {
+        return _ticks;
+    }
+
+    const glm::vec3& playerPos() const
+    {
+        return _playerPos;
+    }
+
+    const glm::vec2& playerVel() const
+    {
+        return _playerVel;
+    }
+
+    JumpState playerJumpState() const
+    {
+        return _playerJumpState;
+    }
+
+    const glm::vec2& camera2d() const
+    {
+        return _camera2d;
+    }
+
+    float shake() const
+    {
+        return _shake;
+    }
+
+    void shakeFor(float duration)
+    {
+        _shakeTimer = duration;
+    }
+
+    bool godMode() const
+    {
+        return _godMode;
+    }
+
+    void setGodMode(bool godMode)
+    {
+        _godMode = godMode;
+    }
+
+    const Counters& counters() const
+    {
+        return _counters;
+    }
+
+    /* Right edge of the map in world units. */
+    float mapEnd() const
+    {
+        return _columnsPerUnit > 0.0f ? _mapColumns / _columnsPerUnit - 0.5f : 0.0f;
+    }
+
+    Projectiles& projectiles()
+    {
+        return _projectiles;
+    }
+
+    const Projectiles& projectiles() const
+    {
+        return _projectiles;
+    }
+
+    Collectables& collectables()
+    {
+        return _collectables;
+    }
+
+    const Collectables& collectables() const
+    {
+        return _collectables;
+    }
+
+    Enemies& enemies()
+    {
+        return _enemies;
+    }
+
+    const Enemies& enemies() const
+    {
+        return _enemies;
+    }
+
+    const ParticleSystem& particles() const
+    {
+        return _particles;
+    }
+
+private:
+    void updateWater();
+
+    void updateCamera(float dt);
+
+    void updateActivation();
+
+    /* Spawns the table entries of region and any regions between it and those already spawned. */
+    void streamSpawns(size_t region);
+
+    /* Frees the sleeping entities of regions more than KeptSpawnRegions from the awake ones. */
+    void evictSpawns();
+
+    /* The first table entry in region or after it. */
+    const SpawnTable::Entry* firstSpawn(size_t region) const;
+
+    /* Whether info's entity came from a table entry of a region no longer spawned. */
+    bool outsideSpawnedRun(const EntityInfo& info) const;
+
+    void updateProjectiles(float dt);
+
+    void updateCollectables(float dt);
+
+    void updateEnemies(float dt);
+
+    void updatePlayer(float dt, const Input& input);
+
+    void updateShake(float dt);
+
+    const unsigned char* _mapBytes{nullptr};
+    size_t _mapColumns{0};
+    float _columnsPerUnit{0.0f};
+    Terrain _terrain;
+    FlowField _flowField;
+    ActivationRegions _activation;
+    ActivationRegions::Sleepers _sleepingCollectables;
+    ActivationRegions::Sleepers _sleepingEnemies;
+    const SpawnTable* _spawns{nullptr};
+    /* The camera moves continuously, so the regions spawned so far are one run. */
+    size_t _spawnedBegin{0};
+    size_t _spawnedEnd{0};
+
+    float _accumulator{0.0f};
+    float _time{0.0f};
+    unsigned long long _ticks{0};
+
+    glm::vec3 _playerPos{-0.5f, 0.0f, 0.0f};
+    /* Player x before the last move, so water cannot be skipped over. */
+    float _playerPrevX{-0.5f};
+    glm::vec2 _playerVel{0.0f, 0.0f};
+    JumpState _playerJumpState{JumpState::GROUNDED};
+
+    glm::vec2 _camera2d{0.0f, 0.0f};
+
+    Projectiles _projectiles;
+    Collectables _collectables;
+    Enemies _enemies;
+    SweepIndex _enemyIndex;
+    SweepIndex _collectableIndex;
+    ParticleSystem _particles{MaxParticles};
+    std::vector<uint32_t> _hits;
+    /* Table entries of the regions being streamed in that are still alive. */
+    std::vector<uint32_t> _liveEntries;
+    std::vector<float> _scratchXs;
+    std::vector<float> _scratchHeights;
+    bool _godMode{false};
+
+    float _shakeTimer{0.0f};
+    float _shake{0.0f};
+    Counters _counters;
+    Random _random;
+    InputLog* _recorder{nullptr};
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "glshaderprogram.h"
+
+/*
+ * GPU time of a span of commands, measured with GL_TIME_ELAPSED queries.
+ * Results are read a few frames late from a ring of queries so reading never
+ * waits on the GPU.
+ */
+class GpuTimer
+{
+public:
+    static constexpr int Latency{3};
+
+    GpuTimer();
+
+    ~GpuTimer() noexcept;
+
+    void begin();
+
+    void end();
+
+    /* The most recent finished measurement in milliseconds, or a negative value if none is ready. */
+    float poll();
+
+private:
+    GLuint _queries[Latency]{};
+    bool _pending[Latency]{};
+    int _next{0};
+};
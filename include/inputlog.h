@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "gameworld.h"
+
+/*
+ * Recorded gameplay session: the seed, the level it was played on and the
+ * input of every fixed step, stored as runs of identical input. Replaying the
+ * log through a fresh GameWorld reproduces the session tick for tick, and the
+ * state hash saved at the end tells whether it still does.
+ *
+ * File layout: Header, the level path, then one (varint tick count, input
+ * bits) pair per run.
+ */
+class InputLog
+{
+public:
+    static constexpr uint32_t Magic{0x504A5253}; // "SRJP"
+    /*
+     * 2: the state hash no longer covers how many entities are awake.
+     * 3: the header holds the spawn table's hash.
+     */
+    static constexpr uint32_t Version{3};
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t seed;
+        uint64_t tickCount;
+        uint64_t finalHash;
+        uint64_t mapHash;
+        uint64_t spawnHash;
+        uint64_t mapColumns;
+        float columnsPerUnit;
+        uint32_t levelPathLength;
+        uint64_t runCount;
+    };
+
+    struct Run
+    {
+        uint32_t ticks;
+        uint8_t bits;
+    };
+
+    /*
+     * Starts a new recording. The map hash identifies the level's starting
+     * bytes and the spawn hash its spawn table, as hashSpawns() gives them.
+     */
+    void begin(uint64_t seed, const std::string& levelPath, uint64_t mapHash, uint64_t spawnHash,
+        uint64_t mapColumns, float columnsPerUnit);
+
+    void record(const GameWorld::Input& input);
+
+    void finish(uint64_t finalHash)
+    {
+        _header.finalHash = finalHash;
+    }
+
+    bool save(const std::string& path) const;
+
+    /*
+     * False if the file is missing, damaged or of another Version. header()
+     * then holds whatever header was read, so a version mismatch can be told
+     * apart.
+     */
+    bool load(const std::string& path);
+
+    /*
+     * Steps world through every recorded tick and returns its final state hash.
+     * The world must hold the recorded level and its spawn table, and nothing
+     * else yet.
+     */
+    uint64_t replay(GameWorld& world) const;
+
+    const Header& header() const
+    {
+        return _header;
+    }
+
+    const std::string& levelPath() const
+    {
+        return _levelPath;
+    }
+
+    const std::vector<Run>& runs() const
+    {
+        return _runs;
+    }
+
+    static uint8_t pack(const GameWorld::Input& input);
+
+    static GameWorld::Input unpack(uint8_t bits);
+
+    static uint64_t hashMap(const unsigned char* bytes, uint64_t size);
+
+    /* Hash of the table's entries; a level without a table passes nullptr. */
+    static uint64_t hashSpawns(const SpawnTable* spawns);
+
+private:
+    Header _header{};
+    std::string _levelPath;
+    std::vector<Run> _runs;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "gameworld.h"
+
+/*
+ * Button transitions stamped with the Profiler clock when they happened,
+ * handed from the window thread to the simulation. Each step takes the
+ * events up to its own start time, so a press counts from the first step
+ * after it instead of from the next frame's poll. A press released again
+ * before a step ran still counts as held for that one step, so short taps
+ * are never lost between steps.
+ */
+class InputQueue
+{
+public:
+    enum class Button : uint8_t
+    {
+        LEFT,
+        RIGHT,
+        JUMP,
+        CRAWL,
+        /* One-shot: only the press matters. */
+        FIRE,
+        SHAKE
+    };
+
+    struct Event
+    {
+        uint64_t time;
+        Button button;
+        bool down;
+    };
+
+    /* Producer side. Events must be pushed in time order. */
+    void push(Button button, bool down, uint64_t time);
+
+    /*
+     * Consumer side: applies every event stamped at or before until and
+     * returns the input for one step.
+     */
+    GameWorld::Input take(uint64_t until);
+
+    /* Stamp of the newest event take() applied, or 0. */
+    uint64_t lastApplied() const
+    {
+        return _lastApplied;
+    }
+
+private:
+    static bool& field(GameWorld::Input& input, Button button);
+
+    std::mutex _mutex;
+    std::vector<Event> _events;
+
+    /* Consumer side only. */
+    std::vector<Event> _taken;
+    GameWorld::Input _held;
+    uint64_t _lastApplied{0};
+};
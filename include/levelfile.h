@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "mappedfile.h"
+
+/*
+ * Compiled level: one row of RGBA columns (R height, B water) cut into fixed
+ * size chunks. The file is a header, a chunk index and the chunks themselves,
+ * each chunk starting on a page boundary:
+ *
+ *   Header      magic "SJLV", version, column layout, chunk count
+ *   Index       one ChunkEntry per chunk
+ *   Chunks      raw column bytes, page aligned
+ *
+ * Raw chunks are stored back to back in column order, so a mapped file can be
+ * handed to the game as one contiguous column array. Only the chunks around
+ * the camera are kept resident; see page().
+ */
+class LevelFile
+{
+public:
+    static constexpr uint32_t Magic{0x564C4A53}; // "SJLV"
+    static constexpr uint32_t Version{1};
+    static constexpr uint32_t BytesPerColumn{4};
+    static constexpr uint32_t DefaultColumnsPerChunk{4096};
+    static constexpr uint64_t PageSize{4096};
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t bytesPerColumn;
+        uint32_t columnsPerChunk;
+        uint64_t columnCount;
+        uint64_t chunkCount;
+        uint64_t indexOffset;
+        float columnsPerUnit;
+        uint32_t reserved;
+    };
+
+    struct ChunkEntry
+    {
+        uint64_t offset;
+        uint32_t size;
+        uint32_t flags;
+    };
+
+    LevelFile() = default;
+
+    ~LevelFile() noexcept;
+
+    LevelFile(const LevelFile&) = delete;
+    LevelFile& operator=(const LevelFile&) = delete;
+
+    /*
+     * Writes columns in the chunked format. The callback fills count columns
+     * starting at first, so levels larger than memory can be generated.
+     */
+    template <typename Generator>
+    static bool write(const std::string& path, uint64_t columnCount, float columnsPerUnit, Generator&& generate,
+        uint32_t columnsPerChunk = DefaultColumnsPerChunk);
+
+    static bool write(const std::string& path, const unsigned char* columns, uint64_t columnCount, float columnsPerUnit,
+        uint32_t columnsPerChunk = DefaultColumnsPerChunk);
+
+    /* Maps the file read-only. Nothing is paged in until it is touched. */
+    bool open(const std::string& path);
+
+    void close();
+
+    bool isOpen() const
+    {
+        return _file.isOpen();
+    }
+
+    /* All columns, contiguous in the mapping. */
+    const unsigned char* columns() const
+    {
+        return _columns;
+    }
+
+    uint64_t columnCount() const
+    {
+        return _header.columnCount;
+    }
+
+    float columnsPerUnit() const
+    {
+        return _header.columnsPerUnit;
+    }
+
+    const Header& header() const
+    {
+        return _header;
+    }
+
+    /*
+     * Keeps the chunks within radius columns of column resident and releases
+     * the rest, so resident memory is bounded by the window and not by the
+     * level length. Returns the number of chunks that changed state.
+     */
+    size_t page(uint64_t column, uint64_t radius);
+
+    /* Chunks currently kept resident by page(). */
+    uint64_t residentChunks() const
+    {
+        return _windowEnd - _windowBegin;
+    }
+
+private:
+    class Writer;
+
+    void advise(uint64_t chunkBegin, uint64_t chunkEnd, bool willNeed);
+
+    MappedFile _file;
+    Header _header{};
+    const ChunkEntry* _index{nullptr};
+    const unsigned char* _columns{nullptr};
+    uint64_t _windowBegin{0};
+    uint64_t _windowEnd{0};
+};
+
+/* Sequential chunk writer behind LevelFile::write. */
+class LevelFile::Writer
+{
+public:
+    Writer(const std::string& path, uint64_t columnCount, float columnsPerUnit, uint32_t columnsPerChunk);
+
+    ~Writer() noexcept;
+
+    bool ok() const
+    {
+        return _file != nullptr && _ok;
+    }
+
+    uint64_t chunkCount() const
+    {
+        return _index.size();
+    }
+
+    uint64_t chunkColumns(uint64_t chunk) const;
+
+    uint32_t columnsPerChunk() const
+    {
+        return _header.columnsPerChunk;
+    }
+
+    uint64_t chunkFirst(uint64_t chunk) const
+    {
+        return chunk * _header.columnsPerChunk;
+    }
+
+    /* Appends the next chunk; columns must hold chunkColumns(chunk) columns. */
+    void writeChunk(uint64_t chunk, const unsigned char* columns);
+
+    bool finish();
+
+private:
+    std::FILE* _file{nullptr};
+    bool _ok{true};
+    Header _header{};
+    std::vector<ChunkEntry> _index;
+    uint64_t _dataOffset{0};
+};
+
+template <typename Generator>
+bool LevelFile::write(const std::string& path, uint64_t columnCount, float columnsPerUnit, Generator&& generate,
+    uint32_t columnsPerChunk)
+{
+    Writer writer{path, columnCount, columnsPerUnit, columnsPerChunk};
+    std::vector<unsigned char> chunk(static_cast<size_t>(writer.columnsPerChunk()) * BytesPerColumn);
+    for(uint64_t i = 0; i < writer.chunkCount() && writer.ok(); ++i)
+    {
+        generate(writer.chunkFirst(i), writer.chunkColumns(i), chunk.data());
+        writer.writeChunk(i, chunk.data());
+    }
+    return writer.finish();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/*
+ * An editable level image such as level.png, decoded to MapStride bytes per
+ * pixel with the edits left in its MapSaver journal applied. The game plays
+ * the first row. Decoding needs no GL context, so it can run on a
+ * StartupLoader thread while the window is created.
+ */
+class LevelImage
+{
+public:
+    bool load(const std::string& path);
+
+    unsigned char* bytes()
+    {
+        return _pixels.data();
+    }
+
+    const unsigned char* bytes() const
+    {
+        return _pixels.data();
+    }
+
+    int width() const
+    {
+        return _width;
+    }
+
+    int height() const
+    {
+        return _height;
+    }
+
+    const std::string& path() const
+    {
+        return _path;
+    }
+
+    /* Journal records applied on load. */
+    size_t unsavedEdits() const
+    {
+        return _unsavedEdits;
+    }
+
+private:
+    std::string _path;
+    std::vector<unsigned char> _pixels;
+    int _width{0};
+    int _height{0};
+    size_t _unsavedEdits{0};
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/*
+ * Edits to the level map. Every change is recorded in an undo journal and
+ * marks its column dirty; flush() hands the dirty columns over as coalesced
+ * spans once per frame, so the upload cost follows the edit and not the
+ * width of the level.
+ */
+class MapEditor
+{
+public:
+    static constexpr size_t MaxJournal{4096};
+    /* Spans closer than this are uploaded as one. */
+    static constexpr size_t MergeGap{16};
+
+    struct Span
+    {
+        size_t first;
+        size_t count;
+    };
+
+    struct Stats
+    {
+        size_t edits{0};
+        size_t spans{0};
+        size_t bytes{0};
+    };
+
+    void setMap(unsigned char* bytes, size_t columns, int stride);
+
+    size_t columns() const
+    {
+        return _columns;
+    }
+
+    unsigned char get(size_t column, int channel) const
+    {
+        return _bytes[column * _stride + channel];
+    }
+
+    /* Writes one channel of one column. Returns false if nothing changed. */
+    bool set(size_t column, int channel, unsigned char value);
+
+    bool undo();
+
+    bool redo();
+
+    bool canUndo() const
+    {
+        return _cursor > 0;
+    }
+
+    bool canRedo() const
+    {
+        return _cursor < _journal.size();
+    }
+
+    bool dirty() const
+    {
+        return !_dirty.empty();
+    }
+
+    /*
+     * Calls upload(span) for each dirty span, merged and in column order, and
+     * clears the dirty set. Returns the number of spans.
+     */
+    template <typename Upload>
+    size_t flush(Upload&& upload)
+    {
+        coalesce();
+        for(const Span& span : _dirty)
+        {
+            upload(span);
+            _stats.bytes += span.count * _stride;
+        }
+        size_t spans = _dirty.size();
+        _stats.spans += spans;
+        _dirty.clear();
+        return spans;
+    }
+
+    const Stats& stats() const
+    {
+        return _stats;
+    }
+
+private:
+    struct Edit
+    {
+        uint32_t column;
+        uint8_t channel;
+        uint8_t before;
+        uint8_t after;
+    };
+
+    void apply(const Edit& edit, bool forward);
+
+    void markDirty(size_t column);
+
+    void coalesce();
+
+    unsigned char* _bytes{nullptr};
+    size_t _columns{0};
+    int _stride{4};
+    std::deque<Edit> _journal;
+    size_t _cursor{0};
+    std::vector<Span> _dirty;
+    Stats _stats;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/*
+ * A whole file mapped read-only. Pages come in as they are touched; advise()
+ * hints which ranges will be needed next and which can go.
+ */
+class MappedFile
+{
+public:
+    enum class Advice
+    {
+        /* Fault in only what is touched, without read-ahead. */
+        RANDOM,
+        WILL_NEED,
+        DONT_NEED
+    };
+
+    MappedFile() = default;
+
+    ~MappedFile() noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /* False for missing or empty files. */
+    bool open(const std::string& path);
+
+    void close();
+
+    bool isOpen() const
+    {
+        return _data != nullptr;
+    }
+
+    const unsigned char* data() const
+    {
+        return _data;
+    }
+
+    uint64_t size() const
+    {
+        return _size;
+    }
+
+    /* Widened to whole pages and clipped to the file. */
+    void advise(uint64_t offset, uint64_t length, Advice advice);
+
+private:
+    unsigned char* _data{nullptr};
+    uint64_t _size{0};
+#ifdef _WIN32
+    void* _file{nullptr};
+    void* _mapping{nullptr};
+#else
+    int _fd{-1};
+#endif
+};
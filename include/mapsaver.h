@@ -0,0 +1,138 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mapeditor.h"
+
+/*
+ * Writes the edited level image on a thread of its own, so saving never
+ * stalls a frame.
+ *
+ * The writer keeps its own copy of the image, taken at load, and every edit
+ * reaches it as a small record of the edited columns. Those records are
+ * appended to a journal next to the image and patched into the copy, so by
+ * the time the writer gets to a save its copy is the map as it was when
+ * save() was called. save() itself copies nothing, so the frame pays for the
+ * edits and not for the size of the level. The writer encodes the PNG next
+ * to the level and renames it over the old one, so the file on disk is
+ * always a complete image.
+ *
+ * Between saves every edit is appended to a journal next to the image. A
+ * session that ends without saving leaves the journal behind and the next
+ * one replays it on load; a finished save empties it.
+ *
+ *   Journal     magic "SJMJ", version, width, channels
+ *   Records     first column, column count, count * channels bytes
+ */
+class MapSaver
+{
+public:
+    static constexpr uint32_t JournalMagic{0x4A4D4A53}; // "SJMJ"
+    static constexpr uint32_t JournalVersion{1};
+
+    struct JournalHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t width;
+        uint32_t channels;
+    };
+
+    struct Stats
+    {
+        size_t saves{0};
+        size_t failures{0};
+        size_t journalRecords{0};
+        /* Encode and write time of the last save, on the writer thread. */
+        double lastWriteSeconds{0.0};
+    };
+
+    MapSaver();
+
+    /* Finishes whatever is queued before returning. */
+    ~MapSaver() noexcept;
+
+    MapSaver(const MapSaver&) = delete;
+    MapSaver& operator=(const MapSaver&) = delete;
+
+    /*
+     * bytes is the image as loaded, width by height pixels of channels bytes,
+     * and must outlive the saver. Edits are to its first row, one pixel per
+     * MapEditor column. Copies the whole image, so call it at load time.
+     */
+    void setMap(const unsigned char* bytes, int width, int height, int channels, const std::string& path);
+
+    /* Call for each span MapEditor::flush() hands out, after the edit. */
+    void changed(const MapEditor::Span& span);
+
+    /*
+     * Queues a save of the map as it is now, with every edit passed to
+     * changed() so far. A save still waiting for the writer covers this one.
+     */
+    void save();
+
+    /* Blocks until everything queued has been written. */
+    void wait();
+
+    bool busy() const;
+
+    Stats stats() const;
+
+    static std::string journalPath(const std::string& path)
+    {
+        return path + ".journal";
+    }
+
+    /*
+     * Applies the journal a previous session left next to path to the first
+     * row of bytes. Returns the number of records applied; a journal made for
+     * another width is ignored, and a torn last record is dropped.
+     */
+    static size_t replayJournal(const std::string& path, unsigned char* bytes, int width, int channels);
+
+private:
+    /* A journal record, or a save of everything recorded before it. */
+    struct Job
+    {
+        bool save{false};
+        uint32_t first{0};
+        uint32_t count{0};
+        std::vector<unsigned char> bytes;
+    };
+
+    void run();
+
+    void appendJournal(const Job& job);
+
+    bool write();
+
+    /* Starts an empty journal. */
+    bool resetJournal();
+
+    const unsigned char* _bytes{nullptr};
+    int _width{0};
+    int _height{0};
+    int _channels{4};
+    std::string _path;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _idle;
+    std::vector<Job> _jobs;
+    bool _writing{false};
+    bool _stopping{false};
+    Stats _stats;
+
+    /* Writer thread only, once setMap() has returned. */
+    std::vector<Job> _batch;
+    /* The map with every record taken so far applied. */
+    std::vector<unsigned char> _image;
+    std::FILE* _journal{nullptr};
+
+    std::thread _thread;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "random.h"
+
+/*
+ * Cosmetic particles for pickups, deaths, impacts and splashes. Storage is
+ * structure-of-arrays in blocks of Lanes particles, allocated once at the
+ * given capacity: each block holds one small array per field, so update()
+ * integrates a block with loops the compiler vectorizes without having to
+ * prove the fields apart, noting which blocks had a particle expire. Bursts
+ * fill the end and expired particles are replaced from the end. Bursts past
+ * capacity are cut short rather than growing anything.
+ *
+ * Particles are not gameplay state; they have their own random generator and
+ * are not saved, hashed or replayed.
+ */
+class ParticleSystem
+{
+public:
+    enum Kind : uint8_t
+    {
+        COLLECT,
+        DEATH,
+        IMPACT,
+        SPLASH
+    };
+
+    static constexpr size_t KindCount{4};
+    static constexpr int Lanes{8};
+
+    explicit ParticleSystem(size_t capacity);
+
+    /* Spawns the usual number of particles for kind; returns how many fit. */
+    size_t burst(Kind kind, const glm::vec2& position);
+
+    size_t burst(Kind kind, const glm::vec2& position, size_t count);
+
+    /* Moves every particle by dt and drops the ones that expired. */
+    void update(float dt);
+
+    void clear()
+    {
+        _count = 0;
+    }
+
+    size_t size() const
+    {
+        return _count;
+    }
+
+    size_t capacity() const
+    {
+        return _kind.size();
+    }
+
+    glm::vec2 position(size_t index) const
+    {
+        const Block& block = _blocks[index / Lanes];
+        return glm::vec2(block.x[index % Lanes], block.y[index % Lanes]);
+    }
+
+    /* Remaining life over the life it started with: 1 at spawn, 0 when it expires. */
+    float fade(size_t index) const
+    {
+        return _blocks[index / Lanes].life[index % Lanes] * _invLifetime[index];
+    }
+
+    Kind kind(size_t index) const
+    {
+        return _kind[index];
+    }
+
+private:
+    struct Block
+    {
+        float x[Lanes];
+        float y[Lanes];
+        float vx[Lanes];
+        float vy[Lanes];
+        float gravity[Lanes];
+        float life[Lanes];
+    };
+
+    void move(size_t from, size_t to);
+
+    size_t _count{0};
+    std::vector<Block> _blocks;
+    /* Only read when snapshotting, so kept out of the blocks update() streams through. */
+    std::vector<float> _invLifetime;
+    std::vector<Kind> _kind;
+    /* Blocks where something expired this update, in order. */
+    std::vector<size_t> _expiring;
+    Random _random{0x5EED};
+};
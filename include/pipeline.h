@@ -1,10 +1,14 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include "glsimplecamera.h"
 #include "glrenderpipeline.h"
 #include "glframebuffer.h"
 #include "gluniformbufferobject.h"
+#include "rendertarget.h"
+#include "gputimer.h"
+#include "resolutioncontroller.h"
 
 class Pipeline : public lithium::RenderPipeline
 {
@@ -15,7 +19,8 @@ public:
         BACKGROUND
     };
 
-    Pipeline(const glm::ivec2& resolution);
+    /* screenFragSrc is screenFragmentSource(), which can be built off the GL thread ahead of time. */
+    Pipeline(const glm::ivec2& resolution, const std::string& screenFragSrc);
 
     ~Pipeline() noexcept;
 
@@ -24,6 +29,9 @@ public:
         return _camera;
     }
 
+    /* The screen shader's fragment source with the generated declarations. Needs no GL context. */
+    static std::string screenFragmentSource();
+
     virtual void setResolution(const glm::ivec2& resolution) override;
 
     void setTime(float time)
@@ -36,6 +44,17 @@ public:
         return _time;
     }
 
+    /* Size the screen shader renders at before it is upscaled to resolution(). */
+    glm::ivec2 internalResolution() const
+    {
+        return _resolutionController.resolution(resolution());
+    }
+
+    const ResolutionController& resolutionController() const
+    {
+        return _resolutionController;
+    }
+
 private:
     /* Shaders */
     std::shared_ptr<lithium::ShaderProgram> _screenShader{nullptr};
@@ -51,4 +70,11 @@ private:
     std::shared_ptr<lithium::Mesh> _screenMesh;
 
     float _time{0.0f};
+
+    /* Dynamic resolution */
+    std::shared_ptr<lithium::ShaderProgram> _upscaleShader{nullptr};
+    GLuint _upscaleVertexArray{0};
+    std::shared_ptr<RenderTarget> _sceneTarget;
+    std::shared_ptr<GpuTimer> _gpuTimer;
+    ResolutionController _resolutionController;
 };
\ No newline at end of file
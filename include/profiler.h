@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*
+ * Scoped timing zones for the frame loop. Each thread writes its samples into
+ * its own ring buffer, so recording takes no lock; the most recent samples can
+ * be exported as Chrome trace_event JSON (chrome://tracing, Perfetto) or
+ * summarized per zone.
+ *
+ * PROFILE_ZONE compiles to nothing unless SUSJAM23_PROFILE is defined, which
+ * the SUSJAM23_PROFILE CMake option does.
+ */
+class Profiler
+{
+public:
+    static constexpr size_t RingSize{1 << 16};
+
+    struct Sample
+    {
+        const char* name;
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    struct ZoneStats
+    {
+        std::string name;
+        size_t count;
+        double p50;
+        double p99;
+        double total;
+    };
+
+    class Zone
+    {
+    public:
+        explicit Zone(const char* name) : _name{name}, _begin{now()}
+        {
+        }
+
+        ~Zone() noexcept
+        {
+            record(_name, _begin, now());
+        }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* _name;
+        uint64_t _begin;
+    };
+
+    /* Nanoseconds on a steady clock. */
+    static uint64_t now();
+
+    /* name must outlive the profiler; zones use string literals. */
+    static void record(const char* name, uint64_t begin, uint64_t end);
+
+    /* Per-zone durations in microseconds over the samples still buffered. */
+    static std::vector<ZoneStats> summary();
+
+    static void printSummary(std::FILE* out);
+
+    static bool writeChromeTrace(const std::string& path);
+
+    /* Drops all buffered samples. Only call while no zone is open. */
+    static void clear();
+
+private:
+    struct Ring
+    {
+        uint32_t thread;
+        std::atomic<uint64_t> head{0};
+        Sample samples[RingSize];
+    };
+
+    static Ring& ring();
+
+    /* Copies out each thread's buffered samples. */
+    static std::vector<std::pair<uint32_t, std::vector<Sample>>> snapshot();
+};
+
+#ifdef SUSJAM23_PROFILE
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_CONCAT(profileZone, __LINE__){name}
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#endif
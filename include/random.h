@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Small seedable generator (splitmix64) for gameplay. Unlike rand() its state
+ * is owned by the world, so a seed and the inputs reproduce a session.
+ */
+class Random
+{
+public:
+    explicit Random(uint64_t seed = 0)
+    {
+        setSeed(seed);
+    }
+
+    void setSeed(uint64_t seed)
+    {
+        _state = seed;
+    }
+
+    uint64_t state() const
+    {
+        return _state;
+    }
+
+    uint64_t next()
+    {
+        uint64_t z = (_state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /* Uniform in [0, bound). */
+    uint32_t below(uint32_t bound)
+    {
+        return static_cast<uint32_t>((next() >> 32) * bound >> 32);
+    }
+
+private:
+    uint64_t _state{0};
+};
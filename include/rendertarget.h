@@ -0,0 +1,41 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "glshaderprogram.h"
+
+/*
+ * Single-sampled color target for rendering below the window's resolution.
+ * bind() remembers the framebuffer and viewport it replaces so unbind() can
+ * put them back, whatever the application framework had bound.
+ */
+class RenderTarget
+{
+public:
+    RenderTarget();
+
+    ~RenderTarget() noexcept;
+
+    /* Reallocates the color texture only when the size changes. */
+    void resize(const glm::ivec2& size);
+
+    void bind();
+
+    void unbind();
+
+    GLuint texture() const
+    {
+        return _texture;
+    }
+
+    const glm::ivec2& size() const
+    {
+        return _size;
+    }
+
+private:
+    GLuint _framebuffer{0};
+    GLuint _texture{0};
+    glm::ivec2 _size{0};
+    GLint _previousFramebuffer{0};
+    GLint _previousViewport[4]{};
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+/*
+ * Picks the render scale of the screen pass from measured frame times. The
+ * shader's cost is per pixel, so the scale that meets the budget is about
+ * scale * sqrt(budget / time). Frame times are smoothed, nothing changes while
+ * they stay inside a band around the budget, and after a change the controller
+ * waits for the new scale to show up in the measurements before acting again.
+ *
+ * Headless on purpose: feed it any trace of frame times.
+ */
+class ResolutionController
+{
+public:
+    struct Config
+    {
+        float budgetMs{6.0f};
+        float minScale{0.5f};
+        float maxScale{1.0f};
+        /* Half width of the dead band, as a fraction of the budget. */
+        float hysteresis{0.1f};
+        /* Weight of the newest sample in the moving average. */
+        float smoothing{0.2f};
+        /* Frames to wait after a change. */
+        int settleFrames{20};
+        /* Largest change per step; dropping is allowed to be faster than rising. */
+        float maxStepDown{0.2f};
+        float maxStepUp{0.05f};
+        /* Internal sizes are rounded to this many pixels. */
+        int granularity{8};
+    };
+
+    ResolutionController();
+
+    explicit ResolutionController(const Config& config);
+
+    /* Feeds the time of the last frame rendered at scale(); returns the scale for the next. */
+    float update(float frameMs);
+
+    float scale() const
+    {
+        return _scale;
+    }
+
+    float smoothedMs() const
+    {
+        return _smoothedMs;
+    }
+
+    /* Number of times the scale has changed. */
+    int changes() const
+    {
+        return _changes;
+    }
+
+    const Config& config() const
+    {
+        return _config;
+    }
+
+    /* The internal render size for a native size at the current scale. */
+    glm::ivec2 resolution(const glm::ivec2& native) const;
+
+private:
+    Config _config;
+    float _scale;
+    float _smoothedMs{0.0f};
+    bool _primed{false};
+    int _framesSinceChange{0};
+    int _changes{0};
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <vector>
+#include "gameworld.h"
+
+/*
+ * History of world states, one per step, for scrubbing gameplay backwards.
+ *
+ * Every push saves the world with GameWorld::saveState() and stores it XOR'd
+ * against the state of the step before, run-length encoded. Most of the
+ * world does not change from one step to the next, so a delta is a few
+ * runs of zeros around the bytes that moved. Every keyframeInterval steps
+ * the state is stored whole instead, so restoring any tick decodes at most
+ * one keyframe and keyframeInterval deltas.
+ *
+ * Encoded frames are written one after another into a ring of budgetBytes,
+ * allocated on the first push, so a full buffer pushes without touching the
+ * heap. When a frame does not fit, or maxFrames are held, the oldest
+ * keyframe and its deltas are dropped together.
+ */
+class RewindBuffer
+{
+public:
+    struct Config
+    {
+        size_t budgetBytes{16u << 20};
+        /* Five minutes at the fixed rate. */
+        size_t maxFrames{36000};
+        int keyframeInterval{120};
+    };
+
+    RewindBuffer();
+
+    explicit RewindBuffer(const Config& config);
+
+    /*
+     * Records the world as it is after its latest step. Pushing a tick that
+     * is not one past the newest, as after a restore, drops every frame
+     * from that tick on and starts a new keyframe.
+     */
+    void push(const GameWorld& world);
+
+    /* Puts world back to where it was at tick. False if tick is not held. */
+    bool restore(unsigned long long tick, GameWorld& world);
+
+    void clear();
+
+    bool empty() const
+    {
+        return _count == 0;
+    }
+
+    unsigned long long oldestTick() const
+    {
+        return _count ? frame(0).tick : 0;
+    }
+
+    unsigned long long newestTick() const
+    {
+        return _count ? frame(_count - 1).tick : 0;
+    }
+
+    size_t frames() const
+    {
+        return _count;
+    }
+
+    /* Encoded size of all frames held. */
+    size_t bytes() const
+    {
+        return _bytes;
+    }
+
+    const Config& config() const
+    {
+        return _config;
+    }
+
+    /*
+     * Writes state XOR base (the shorter zero-extended) to out as run-length
+     * encoded (zero run, literal run) pairs after the state size. base may be
+     * empty.
+     */
+    static void encode(const std::vector<unsigned char>& state, const std::vector<unsigned char>& base,
+        std::vector<unsigned char>& out);
+
+    /* Turns the base in state into the encoded state in place. */
+    static bool decode(const unsigned char* in, size_t size, std::vector<unsigned char>& state);
+
+    /* The reverse of decode(): turns the encoded state in state back into its base of baseSize bytes. */
+    static bool undo(const unsigned char* in, size_t size, size_t baseSize, std::vector<unsigned char>& state);
+
+private:
+    struct Frame
+    {
+        unsigned long long tick{0};
+        /* Frames back to the keyframe this one decodes from; 0 for a keyframe. */
+        uint32_t keyOffset{0};
+        uint32_t size{0};
+        /* Size of the state the delta is against, for undoing it. */
+        uint32_t baseSize{0};
+        size_t offset{0};
+    };
+
+    /* index 0 is the oldest frame held. */
+    Frame& frame(size_t index)
+    {
+        return _ring[(_first + index) % _ring.size()];
+    }
+
+    const Frame& frame(size_t index) const
+    {
+        return _ring[(_first + index) % _ring.size()];
+    }
+
+    /*
+     * Finds room for size bytes after the newest frame, dropping old groups.
+     * Returns false if that dropped the newest frame itself.
+     */
+    bool makeRoom(size_t size, size_t& offset);
+
+    void dropOldestGroup();
+
+    void truncate(unsigned long long tick);
+
+    Config _config;
+    std::vector<unsigned char> _arena;
+    std::vector<Frame> _ring;
+    size_t _first{0};
+    size_t _count{0};
+    /* Arena offset just past the newest frame. */
+    size_t _head{0};
+    size_t _bytes{0};
+    bool _forceKeyframe{false};
+
+    /* Raw state of the newest frame, the base of the next delta. */
+    std::vector<unsigned char> _previous;
+    std::vector<unsigned char> _state;
+    std::vector<unsigned char> _encoded;
+
+    /* Last restored state, so scrubbing either way decodes one delta per tick. */
+    std::vector<unsigned char> _decoded;
+    unsigned long long _decodedTick{0};
+    bool _decodedValid{false};
+};
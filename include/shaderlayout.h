@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <glm/glm.hpp>
+
+/*
+ * Compile-time description of a std140 uniform block. A C++ struct lists its
+ * members once as Fields; the table is checked against the std140 rules with
+ * static_assert and turned into the GLSL block declaration at startup, so the
+ * shader and the upload can not drift apart.
+ *
+ * Only the scalar and vector types the shaders use are described. Arrays and
+ * nested structs are not, because std140 pads them to vec4 strides that a
+ * plain C++ struct does not follow.
+ */
+namespace shaderlayout
+{
+    template <typename T>
+    struct GlslType;
+
+    template <>
+    struct GlslType<float>
+    {
+        static constexpr const char* name{"float"};
+        static constexpr size_t align{4};
+    };
+
+    template <>
+    struct GlslType<int>
+    {
+        static constexpr const char* name{"int"};
+        static constexpr size_t align{4};
+    };
+
+    template <>
+    struct GlslType<glm::vec2>
+    {
+        static constexpr const char* name{"vec2"};
+        static constexpr size_t align{8};
+    };
+
+    template <>
+    struct GlslType<glm::vec3>
+    {
+        static constexpr const char* name{"vec3"};
+        static constexpr size_t align{16};
+    };
+
+    template <>
+    struct GlslType<glm::vec4>
+    {
+        static constexpr const char* name{"vec4"};
+        static constexpr size_t align{16};
+    };
+
+    struct Field
+    {
+        const char* type;
+        const char* name;
+        size_t offset;
+        size_t size;
+        size_t align;
+    };
+
+    template <typename T>
+    constexpr Field field(const char* name, size_t offset)
+    {
+        return Field{GlslType<T>::name, name, offset, sizeof(T), GlslType<T>::align};
+    }
+
+    constexpr size_t alignUp(size_t value, size_t align)
+    {
+        return (value + align - 1) / align * align;
+    }
+
+    /*
+     * True when every field sits where std140 would put it after the one
+     * before it, i.e. the C++ struct can be copied into the buffer as is.
+     */
+    template <size_t N>
+    constexpr bool isStd140(const std::array<Field, N>& fields)
+    {
+        size_t offset{0};
+        for(size_t i = 0; i < N; ++i)
+        {
+            if(fields[i].offset != alignUp(offset, fields[i].align))
+            {
+                return false;
+            }
+            offset = fields[i].offset + fields[i].size;
+        }
+        return true;
+    }
+
+    /* Size of the block as std140 rounds it, which is what GL reports for it. */
+    template <size_t N>
+    constexpr size_t blockSize(const std::array<Field, N>& fields)
+    {
+        return N == 0 ? 0 : alignUp(fields[N - 1].offset + fields[N - 1].size, 16);
+    }
+
+    /* "layout(std140) uniform <block>\n{\n    <type> <name>;\n ...};\n" */
+    std::string declareBlock(const char* block, const Field* fields, size_t count);
+
+    template <size_t N>
+    std::string declareBlock(const char* block, const std::array<Field, N>& fields)
+    {
+        return declareBlock(block, fields.data(), N);
+    }
+
+    /* "const int <name> = <value>;\n" */
+    std::string declareConstant(const char* name, int value);
+    std::string declareConstant(const char* name, float value);
+}
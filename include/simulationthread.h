@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "gameworld.h"
+#include "inputqueue.h"
+#include "rewindbuffer.h"
+#include "triplebuffer.h"
+#include "worldsnapshot.h"
+
+/*
+ * Steps a GameWorld at its fixed rate on a thread of its own and publishes a
+ * WorldSnapshot after every step through a triple buffer. The render side
+ * reads the two most recent snapshots and blends between them, so frame rate
+ * and simulation rate are independent and neither stalls the other.
+ *
+ * While the thread runs it owns the world. Other threads talk to it through
+ * setInput() and post() only.
+ */
+class SimulationThread
+{
+public:
+    explicit SimulationThread(GameWorld& world);
+
+    ~SimulationThread() noexcept;
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    void start();
+
+    /* Joins the thread; the world is the caller's again afterwards. */
+    void stop();
+
+    /*
+     * Held buttons replace the previous input. One-shot actions accumulate
+     * until a step consumes them, however often this is called in between.
+     */
+    void setInput(const GameWorld::Input& input);
+
+    /*
+     * Timestamped button events, taken by each step up to its start time.
+     * Combined with whatever setInput() last gave.
+     */
+    InputQueue& inputQueue()
+    {
+        return _inputQueue;
+    }
+
+    /* Every step is pushed to rewind while it is set. Set before start(). */
+    void setRewind(RewindBuffer* rewind)
+    {
+        _rewind = rewind;
+    }
+
+    /*
+     * While set, each step restores the tick before the current one instead
+     * of stepping, so history plays backwards at the simulation rate. Play
+     * resumes from wherever it stopped and overwrites the history after it.
+     */
+    void setRewinding(bool rewinding)
+    {
+        _rewinding.store(rewinding, std::memory_order_relaxed);
+    }
+
+    /* Runs job on the simulation thread before its next step. */
+    void post(std::function<void(GameWorld&)> job);
+
+    /*
+     * Render side: the world as of now, one step behind the newest snapshot
+     * and blended between the two latest. Returns false until the first step.
+     */
+    bool read(WorldSnapshot& out);
+
+    unsigned long long steps() const
+    {
+        return _steps.load(std::memory_order_relaxed);
+    }
+
+private:
+    void run();
+
+    GameWorld& _world;
+    std::thread _thread;
+    std::atomic<bool> _running{false};
+    std::atomic<uint8_t> _held{0};
+    std::atomic<uint8_t> _oneShots{0};
+    std::atomic<unsigned long long> _steps{0};
+    std::atomic<bool> _rewinding{false};
+    InputQueue _inputQueue;
+    RewindBuffer* _rewind{nullptr};
+
+    std::mutex _jobMutex;
+    std::vector<std::function<void(GameWorld&)>> _jobs;
+    std::vector<std::function<void(GameWorld&)>> _runningJobs;
+
+    TripleBuffer<WorldSnapshot> _snapshots;
+
+    /* Reader side only. */
+    WorldSnapshot _previous;
+    WorldSnapshot _current;
+    unsigned long long _received{0};
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "columnbins.h"
+#include "terraincolumns.h"
+#include "threadpool.h"
+
+/*
+ * CPU port of the screen shader in pipeline.cpp, for rendering frames without
+ * a GPU. The framebuffer is split into tiles spread over a thread pool. Within
+ * a tile, everything that only depends on the column is computed once and the
+ * rows are shaded a batch of lanes at a time with branch-free loops the
+ * compiler can vectorize.
+ *
+ * The terrain displacement comes from the same TerrainColumns pass the GPU
+ * path uses. There is no multisampling.
+ */
+class SoftwareRenderer
+{
+public:
+    /* The shader inputs for one frame. */
+    struct Frame
+    {
+        glm::ivec2 resolution{1440, 800};
+        glm::vec2 camera{0.0f};
+        glm::vec3 playerPos{0.0f};
+        float time{0.0f};
+        float shake{0.0f};
+        const ColumnBins* bins{nullptr};
+        const unsigned char* map{nullptr};
+        size_t mapColumns{0};
+        float columnsPerUnit{0.0f};
+        int mapStride{GameWorld::MapStride};
+    };
+
+    static constexpr int TileSize{64};
+    static constexpr int Lanes{8};
+
+    explicit SoftwareRenderer(std::shared_ptr<ThreadPool> threadPool = nullptr);
+
+    /* Renders RGB8, top row first. */
+    void render(const Frame& frame, std::vector<unsigned char>& rgb);
+
+    static bool writePpm(const std::string& path, const std::vector<unsigned char>& rgb, const glm::ivec2& resolution);
+
+    /* Reads what writePpm() wrote. */
+    static bool readPpm(const std::string& path, std::vector<unsigned char>& rgb, glm::ivec2& resolution);
+
+private:
+    void renderTile(const Frame& frame, int tileX, int tileY, unsigned char* rgb) const;
+
+    std::shared_ptr<ThreadPool> _threadPool;
+    TerrainColumns _terrain;
+};
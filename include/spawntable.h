@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "mappedfile.h"
+
+/*
+ * Where a level's collectables and enemies start, kept next to the level as
+ * levelPath + ".spawns". The file is a header followed by fixed size entries
+ * sorted by x:
+ *
+ *   Header      magic "SJSP", version, entry count
+ *   Entries     quantized x and y, type tag
+ *
+ * open() maps the file and only checks the header, so loading takes the same
+ * time however many entries there are; GameWorld reads the entries of each
+ * region as the camera first comes near it.
+ */
+class SpawnTable
+{
+public:
+    static constexpr uint32_t Magic{0x50534A53}; // "SJSP"
+    static constexpr uint32_t Version{1};
+    /* Quantization steps per world unit. */
+    static constexpr float Resolution{4096.0f};
+    /* x is stored from here, so the furthest entry is about a million units away. */
+    static constexpr float MinX{-16.0f};
+
+    enum class Type : uint8_t
+    {
+        COLLECTABLE,
+        ENEMY
+    };
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t count;
+    };
+
+    struct Entry
+    {
+        uint32_t x;
+        int16_t y;
+        Type type;
+        uint8_t reserved;
+    };
+
+    struct Spawn
+    {
+        Type type;
+        glm::vec2 position;
+    };
+
+    SpawnTable() = default;
+
+    SpawnTable(const SpawnTable&) = delete;
+    SpawnTable& operator=(const SpawnTable&) = delete;
+
+    static std::string tablePath(const std::string& levelPath)
+    {
+        return levelPath + ".spawns";
+    }
+
+    static Entry pack(const Spawn& spawn);
+
+    static glm::vec2 position(const Entry& entry)
+    {
+        return glm::vec2(entry.x / Resolution + MinX, entry.y / Resolution);
+    }
+
+    /* Sorts and quantizes spawns into the table layout. */
+    static std::vector<Entry> build(const std::vector<Spawn>& spawns);
+
+    /*
+     * Reads a text list of spawns, one type and position in world units per
+     * line like "enemy 5.0 0.0" or "collectable 1.2 0.08". Blank lines and
+     * lines starting with # are skipped. On failure line is the first bad
+     * line, or 0 if the file could not be opened.
+     */
+    static bool parse(const std::string& path, std::vector<Spawn>& spawns, int& line);
+
+    static bool write(const std::string& path, const std::vector<Spawn>& spawns);
+
+    /* Entries must already be sorted, as build() leaves them. */
+    static bool write(const std::string& path, const Entry* entries, size_t count);
+
+    /* Maps a table written by write(). */
+    bool open(const std::string& path);
+
+    /* Takes spawns from memory instead, for tools and benchmarks. */
+    void assign(const std::vector<Spawn>& spawns);
+
+    void close();
+
+    const Entry* entries() const
+    {
+        return _entries;
+    }
+
+    size_t size() const
+    {
+        return _count;
+    }
+
+private:
+    MappedFile _file;
+    std::vector<Entry> _owned;
+    const Entry* _entries{nullptr};
+    size_t _count{0};
+};
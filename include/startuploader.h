@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Startup work split into timed phases. Work that needs no GL context, like
+ * decoding the level or assembling shader sources, is start()ed on threads of
+ * its own before the window is created, and the main thread join()s each
+ * task only right before the first use of its result. Main thread phases are
+ * marked with phase() as startup goes along, and finish() ends the last one
+ * once the first frame is done.
+ *
+ * Every phase is also recorded as a Profiler sample, so startup shows up in
+ * the Chrome trace next to the first frames.
+ */
+class StartupLoader
+{
+public:
+    enum class Kind
+    {
+        MAIN,
+        WORKER,
+        /* The main thread blocked in join(). */
+        WAIT
+    };
+
+    struct Phase
+    {
+        /* String literal, as with profiler zones. */
+        const char* name;
+        Kind kind;
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    using Task = size_t;
+
+    StartupLoader();
+
+    /* Joins any task nobody waited for. */
+    ~StartupLoader() noexcept;
+
+    StartupLoader(const StartupLoader&) = delete;
+    StartupLoader& operator=(const StartupLoader&) = delete;
+
+    /* Runs job on a new thread. */
+    Task start(const char* name, std::function<void()> job);
+
+    /* Blocks until task is done. Its results are safe to use afterwards. */
+    void join(Task task);
+
+    /* Ends the current main thread phase and begins the next. */
+    void phase(const char* name);
+
+    /* Ends the current main thread phase; startup is over. */
+    void finish();
+
+    bool finished() const
+    {
+        return _finished;
+    }
+
+    /* Nanoseconds from construction to finish(). */
+    uint64_t total() const
+    {
+        return _end - _begin;
+    }
+
+    /* Finished phases, main thread and waits in order, workers as they ended. */
+    std::vector<Phase> phases() const;
+
+    /* Every phase by start time. */
+    void printBreakdown(std::FILE* out) const;
+
+private:
+    void endPhase(uint64_t now);
+
+    uint64_t _begin{0};
+    uint64_t _end{0};
+    const char* _current{nullptr};
+    uint64_t _currentBegin{0};
+    bool _finished{false};
+
+    std::vector<std::thread> _threads;
+    std::vector<const char*> _taskNames;
+    mutable std::mutex _mutex;
+    std::vector<Phase> _phases;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+/*
+ * Broad phase over one entity pool: dense indices sorted by x. The order is
+ * kept between rebuilds, so entities that moved a little since the last tick
+ * are re-sorted with an insertion pass in close to linear time.
+ */
+class SweepIndex
+{
+public:
+    void rebuild(const glm::vec2* positions, size_t count);
+
+    /*
+     * Calls visit(index) for every entity with minX <= x <= maxX, using the
+     * positions given to the last rebuild. Visiting order is by x.
+     */
+    template <typename Visitor>
+    void query(float minX, float maxX, Visitor&& visit) const
+    {
+        for(size_t i = lowerBound(minX); i < _xs.size() && _xs[i] <= maxX; ++i)
+        {
+            visit(_order[i]);
+        }
+    }
+
+    /* Smallest dense index within range of point, or -1 when there is none. */
+    int firstWithin(const glm::vec2& point, float radiusSquared, const glm::vec2* positions) const;
+
+    size_t size() const
+    {
+        return _order.size();
+    }
+
+private:
+    size_t lowerBound(float x) const;
+
+    std::vector<uint32_t> _order;
+    std::vector<float> _xs;
+};
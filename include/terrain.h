@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Typed view of the level map for gameplay. Heights and water are read from
+ * the RGBA columns where they are, so a streamed level stays in its mapping
+ * and nothing is copied or scanned at load: R is the height and water is
+ * B == 0xFF.
+ *
+ * Range queries for water use sorted runs of water columns. Runs are indexed
+ * per chunk of ChunkColumns the first time a query reaches the chunk, and the
+ * few chunks indexed at a time are reused least recently used first, so the
+ * index is bounded by what gameplay is near rather than by the level length.
+ * The cache makes queries unsafe to call from two threads at once.
+ *
+ * Column c covers x in [c / columnsPerUnit - 0.5, (c + 1) / columnsPerUnit - 0.5).
+ * Heights are the line's offset from the middle of the screen, in world units,
+ * and are interpolated between column centres. Queries outside the map clamp
+ * to the first or last column.
+ */
+class Terrain
+{
+public:
+    static constexpr int Lanes{8};
+    /* The same as a LevelFile chunk, so the index follows what is paged in. */
+    static constexpr size_t ChunkColumns{4096};
+    static constexpr size_t CachedChunks{16};
+
+    struct WaterSpan
+    {
+        uint32_t first;
+        uint32_t last;
+    };
+
+    void build(const unsigned char* bytes, size_t columns, int stride, float columnsPerUnit);
+
+    /* Drops the water index for count columns from first after the map bytes were edited. */
+    void update(size_t first, size_t count);
+
+    size_t columns() const
+    {
+        return _columns;
+    }
+
+    size_t column(float x) const
+    {
+        double column = columnCoordinate(x) + 0.5;
+        if(!(column > 0.0) || _columns == 0)
+        {
+            return 0;
+        }
+        return std::min(static_cast<size_t>(column), _columns - 1);
+    }
+
+    float height(float x) const;
+
+    /* Height at the centre of column. */
+    float columnHeight(size_t column) const
+    {
+        return _bytes[column * _stride + 0] / 255.0f - 0.5f;
+    }
+
+    bool waterColumn(size_t column) const
+    {
+        return _bytes[column * _stride + 2] == 0xFF;
+    }
+
+    /* dHeight/dx of the segment containing x. */
+    float slope(float x) const;
+
+    /* Whether any column touched by [x0, x1] is water. */
+    bool waterBetween(float x0, float x1) const;
+
+    bool inWater(float x) const
+    {
+        return _columns > 0 && waterColumn(column(x));
+    }
+
+    /* height() for count positions, a batch of lanes at a time. */
+    void heights(const float* xs, float* out, size_t count) const;
+
+    /* The water runs of the chunk holding column, clipped to the chunk. */
+    const std::vector<WaterSpan>& water(size_t column) const;
+
+private:
+    struct Chunk
+    {
+        size_t index{SIZE_MAX};
+        uint64_t used{0};
+        std::vector<WaterSpan> water;
+    };
+
+    /* In doubles: a float runs out of precision for column numbers past 2^24. */
+    double columnCoordinate(float x) const
+    {
+        return (0.5 + static_cast<double>(x)) * _columnsPerUnit - 0.5;
+    }
+
+    const Chunk& chunk(size_t index) const;
+
+    const unsigned char* _bytes{nullptr};
+    size_t _columns{0};
+    int _stride{4};
+    double _columnsPerUnit{0.0};
+    mutable std::array<Chunk, CachedChunks> _chunks;
+    mutable uint64_t _uses{0};
+};
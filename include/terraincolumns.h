@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+/*
+ * Vertical displacement of the line for every output column. In the screen
+ * shader the height map sample, the water waves and the shake wobble depend
+ * on the column only, so they are evaluated once per column per frame here
+ * and read back with texelFetch instead of per pixel.
+ */
+class TerrainColumns
+{
+public:
+    struct Input
+    {
+        int width{0};
+        float aspect{1.0f};
+        float camera{0.0f};
+        float time{0.0f};
+        float shake{0.0f};
+        const unsigned char* map{nullptr};
+        size_t mapColumns{0};
+        /* Zero stretches the map over GameWorld::LegacyLevelUnits. */
+        float columnsPerUnit{0.0f};
+        int mapStride{4};
+    };
+
+    void build(const Input& input);
+
+    /* st.x of the column centre, before the player offset is applied. */
+    static float columnX(const Input& input, int column);
+
+    /* Displacement of a single column, as the shader computed it. */
+    static float displacement(const Input& input, float x);
+
+    static float waveSuperposition(float x, float time);
+
+    /*
+     * Height and water at x, filtered like texture(u_map, vec2(x / 4.0, 0.0)).rb
+     * with GL_LINEAR and GL_REPEAT.
+     */
+    static glm::vec2 sampleMap(const Input& input, float x);
+
+    float operator[](int column) const
+    {
+        return _displacement[column];
+    }
+
+    const std::vector<float>& displacements() const
+    {
+        return _displacement;
+    }
+
+private:
+    std::vector<float> _displacement;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Fixed set of worker threads for data-parallel jobs. parallelFor hands out
+ * indices through a shared counter, so uneven items balance themselves. The
+ * calling thread works alongside the pool until every index is done.
+ */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(unsigned threads = std::thread::hardware_concurrency());
+
+    ~ThreadPool() noexcept;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void parallelFor(size_t count, const std::function<void(size_t)>& job);
+
+    /* Workers plus the calling thread. */
+    unsigned concurrency() const
+    {
+        return static_cast<unsigned>(_workers.size()) + 1;
+    }
+
+private:
+    void workerLoop();
+
+    void drain();
+
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    const std::function<void(size_t)>* _job{nullptr};
+    size_t _count{0};
+    std::atomic<size_t> _next{0};
+    unsigned long long _generation{0};
+    unsigned _busy{0};
+    bool _stopping{false};
+};
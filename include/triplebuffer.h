@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/*
+ * Single producer, single consumer handoff of the latest value. The writer
+ * fills back() and publishes it; the reader picks up the most recent
+ * published slot with update(). Neither side ever waits for the other, and
+ * values the reader was too slow to see are simply replaced.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    /* Writer side. */
+    T& back()
+    {
+        return _slots[_back];
+    }
+
+    void publish()
+    {
+        _back = _middle.exchange(static_cast<uint8_t>(_back | Fresh), std::memory_order_acq_rel) & Index;
+    }
+
+    /* Reader side. Returns true if front() changed. */
+    bool update()
+    {
+        if((_middle.load(std::memory_order_relaxed) & Fresh) == 0)
+        {
+            return false;
+        }
+        _front = _middle.exchange(_front, std::memory_order_acq_rel) & Index;
+        return true;
+    }
+
+    const T& front() const
+    {
+        return _slots[_front];
+    }
+
+private:
+    static constexpr uint8_t Index{3};
+    static constexpr uint8_t Fresh{4};
+
+    T _slots[3];
+    uint8_t _back{0};
+    std::atomic<uint8_t> _middle{1};
+    uint8_t _front{2};
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "gameworld.h"
+
+/*
+ * Copy of what rendering needs from one simulation step. Snapshots are
+ * written by the simulation thread and only read afterwards, so the render
+ * side never touches the live world. Entity arrays mirror the pools' dense
+ * order, with the handles kept for matching entities across snapshots.
+ */
+struct WorldSnapshot
+{
+    float time{0.0f};
+    unsigned long long ticks{0};
+    /* Profiler::now() when the step finished. */
+    uint64_t stamp{0};
+    /* Time of the newest input event the step had applied, for latency checks. */
+    uint64_t inputStamp{0};
+
+    glm::vec3 playerPos{0.0f};
+    glm::vec2 camera2d{0.0f};
+    float shake{0.0f};
+
+    std::vector<glm::vec2> projectilePositions;
+    std::vector<uint32_t> projectileHandles;
+
+    std::vector<glm::vec2> enemyPositions;
+    std::vector<GameWorld::Enemy> enemies;
+    std::vector<uint32_t> enemyHandles;
+
+    std::vector<glm::vec2> collectablePositions;
+    std::vector<GameWorld::Collectable> collectables;
+    std::vector<uint32_t> collectableHandles;
+
+    /* Particles have no handles and are not blended. */
+    std::vector<glm::vec2> particlePositions;
+    std::vector<float> particleFades;
+    std::vector<ParticleSystem::Kind> particleKinds;
+
+    /*
+     * Blends positions from a towards b by alpha. Entities are matched by
+     * dense index and handle; anything spawned or moved since a is taken from
+     * b as is. Everything that is not a position comes from b.
+     */
+    static void interpolate(const WorldSnapshot& a, const WorldSnapshot& b, float alpha, WorldSnapshot& out);
+};
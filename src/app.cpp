@@ -1,17 +1,75 @@
 #include "app.h"
 
+#include <algorithm>
+#include <random>
 #include "glplane.h"
 
-App::App() : Application{"lithium-lab", glm::ivec2{1440, 800}, lithium::Application::Mode::MULTISAMPLED_4X, false},
-    _collectables{}, _enemies{}
+void App::Assets::start(StartupLoader& startup, const std::string& path)
 {
-    // Create the render pipeline
-    _pipeline = std::make_shared<Pipeline>(defaultFrameBufferResolution());
+    levelPath = path;
+    levelTask = startup.start("load level", [this]() {
+        if(!levelPath.empty())
+        {
+            // Compiled levels are streamed from disk and cannot be edited in place.
+            level = std::make_shared<LevelFile>();
+            if(!level->open(levelPath))
+            {
+                std::cerr << "Failed to open level " << levelPath << std::endl;
+                level = nullptr;
+            }
+        }
+        if(!level)
+        {
+            image = std::make_shared<LevelImage>();
+            if(!image->load("level.png"))
+            {
+                std::cerr << "Failed to load level.png" << std::endl;
+                image = nullptr;
+            }
+        }
+        std::string spawnPath = SpawnTable::tablePath(level ? levelPath : "level.png");
+        spawns = std::make_shared<SpawnTable>();
+        if(!spawns->open(spawnPath))
+        {
+            std::cerr << "Failed to open " << spawnPath << ", the level has no entities" << std::endl;
+            spawns = nullptr;
+        }
+    });
+    shaderTask = startup.start("shader sources", [this]() {
+        screenFragment = Pipeline::screenFragmentSource();
+    });
+}
 
-    _map = std::shared_ptr<lithium::ImageTexture>(lithium::ImageTexture::load(
-        "level.png", GL_RGB, GL_RGB, 1, true, false
-    ));
+App::App(StartupLoader& startup, Assets& assets, const std::string& recordPath) : Application{"lithium-lab", glm::ivec2{1440, 800}, lithium::Application::Mode::MULTISAMPLED_4X, false},
+    _startup{&startup}
+{
+    // Create the render pipeline
+    startup.phase("pipeline");
+    startup.join(assets.shaderTask);
+    _pipeline = std::make_shared<Pipeline>(defaultFrameBufferResolution(), assets.screenFragment);
+
+    startup.phase("level");
+    startup.join(assets.levelTask);
+    _level = assets.level;
+    _map = assets.image;
+    if(_level)
+    {
+        _world.setMap(_level->columns(), _level->columnCount(), _level->columnsPerUnit());
+    }
+    else if(_map)
+    {
+        if(_map->unsavedEdits() > 0)
+        {
+            std::cout << "Applied " << _map->unsavedEdits() << " unsaved edits from "
+                << MapSaver::journalPath(_map->path()) << std::endl;
+        }
+        _worldMap.assign(_map->bytes(), _map->bytes() + _map->width() * GameWorld::MapStride);
+        _world.setMap(_worldMap.data(), _map->width());
+        _mapEditor.setMap(_map->bytes(), _map->width(), GameWorld::MapStride);
+        _mapSaver.setMap(_map->bytes(), _map->width(), _map->height(), GameWorld::MapStride, _map->path());
+    }
 
+    startup.phase("scene");
     //unsigned char* buf = _map->bytes();
     /*for(auto i = 0; i < _map->width(); ++i)
     {
@@ -27,16 +85,18 @@ App::App() : Application{"lithium-lab", glm::ivec2{1440, 800}, lithium::Applicat
     std::cout << std::endl;
 
     // Create and add a background plane to the render pipeline, and stage it for rendering.
+    // The screen shader reads the map through the terrain and bin buffers, so the plane needs no textures.
     _background = std::make_shared<lithium::Object>(std::shared_ptr<lithium::Mesh>(lithium::Plane2D()),
-        std::vector<lithium::Object::TexturePointer>{_map});
+        std::vector<lithium::Object::TexturePointer>{});
     _background->setGroupId(Pipeline::BACKGROUND);
+    _binTexture = std::make_shared<BufferTexture>(GL_RGBA32F);
+    _terrainTexture = std::make_shared<BufferTexture>(GL_R32F);
     _pipeline->attach(_background.get());
     _background->stage();
 
     // Key cache for rotating the camera left and right.
     _keyCache = std::make_shared<lithium::Input::KeyCache>(
-        std::initializer_list<int>{GLFW_KEY_LEFT, GLFW_KEY_RIGHT, GLFW_KEY_UP, GLFW_KEY_DOWN,
-            GLFW_KEY_A, GLFW_KEY_D, GLFW_KEY_SPACE});
+        std::initializer_list<int>{GLFW_KEY_LEFT, GLFW_KEY_RIGHT, GLFW_KEY_UP, GLFW_KEY_DOWN});
     input()->setKeyCache(_keyCache);
 
     // Escape key to close the application.
@@ -45,35 +105,27 @@ App::App() : Application{"lithium-lab", glm::ivec2{1440, 800}, lithium::Applicat
         return true;
     });
 
-    input()->addPressedCallback(GLFW_KEY_LEFT_CONTROL, [this](int key, int mods) {
-        _playerCrawling = true;
-        return true;
-    });
-
-    input()->addReleasedCallback(GLFW_KEY_LEFT_CONTROL, [this](int key, int mods) {
-        _playerCrawling = false;
-        return true;
-    });
-
-    input()->addPressedCallback(GLFW_KEY_Q, [this](int key, int mods) {
-        for(auto& p : _playerProjectiles)
-        {
-            if(!p.used)
-            {
-                p.used = true;
-                p.inactive = false;
-                p.position = _playerPos;
-                p.velocity = glm::vec2(_playerPos.z * 1.6f, 0.0f);
-                break;
-            }
-        }
-        return true;
-    });
-
-    input()->addPressedCallback(GLFW_KEY_K, [this](int key, int mods) {
-        _shakeTimer = 0.2f;
-        return true;
-    });
+    // Gameplay buttons go to the simulation as timestamped events, so presses
+    // and taps shorter than a frame land on the step they happened before.
+    for(auto binding : {
+        std::make_pair(GLFW_KEY_A, InputQueue::Button::LEFT),
+        std::make_pair(GLFW_KEY_D, InputQueue::Button::RIGHT),
+        std::make_pair(GLFW_KEY_SPACE, InputQueue::Button::JUMP),
+        std::make_pair(GLFW_KEY_LEFT_CONTROL, InputQueue::Button::CRAWL),
+        std::make_pair(GLFW_KEY_Q, InputQueue::Button::FIRE),
+        std::make_pair(GLFW_KEY_K, InputQueue::Button::SHAKE),
+    })
+    {
+        InputQueue::Button button = binding.second;
+        input()->addPressedCallback(binding.first, [this, button](int key, int mods) {
+            _simulation.inputQueue().push(button, true, Profiler::now());
+            return true;
+        });
+        input()->addReleasedCallback(binding.first, [this, button](int key, int mods) {
+            _simulation.inputQueue().push(button, false, Profiler::now());
+            return true;
+        });
+    }
 
     input()->addPressedCallback(GLFW_KEY_UP, [this](int key, int mods) {
         return manipMap(mods, 1, 0);
@@ -91,89 +143,86 @@ App::App() : Application{"lithium-lab", glm::ivec2{1440, 800}, lithium::Applicat
         return manipMap(mods, 8, 2);
     });
 
-    input()->addPressedCallback(GLFW_KEY_S, [this](int key, int mods) {
+    input()->addPressedCallback(GLFW_KEY_Z, [this](int key, int mods) {
         if(mods & GLFW_MOD_ALT)
         {
-            _map->save();
+            _mapEditor.undo();
         }
         return true;
     });
 
-    int next = 0;
-    for(auto &c : {
-        glm::vec2(1.2f, 0.08f),
-        glm::vec2(1.3f, 0.08f),
-        glm::vec2(1.4f, 0.08f),
-        glm::vec2(1.8f, 0.32f),
-        glm::vec2(2.0f, 0.32f),
-        glm::vec2(6.0f, 0.08f),
-        glm::vec2(6.1f, 0.08f),
-        glm::vec2(6.1f, 0.16f),
-        glm::vec2(6.2f, 0.08f),
-    })
+    input()->addPressedCallback(GLFW_KEY_Y, [this](int key, int mods) {
+        if(mods & GLFW_MOD_ALT)
+        {
+            _mapEditor.redo();
+        }
+        return true;
+    });
+
+    input()->addPressedCallback(GLFW_KEY_S, [this](int key, int mods) {
+        if(_map && (mods & GLFW_MOD_ALT))
+        {
+            _saveRequested = true;
+        }
+        return true;
+    });
+
+    _recordSeed = std::random_device{}();
+    _world.setSeed(_recordSeed);
+    _spawns = assets.spawns;
+    _world.setSpawns(_spawns.get());
+
+    if(!recordPath.empty())
     {
-        _collectables[next].used = true;
-        _collectables[next].position = c;
-        next++;
+        // Edits are not part of the log, so the map stays as loaded while recording.
+        _recordPath = recordPath;
+        const unsigned char* bytes = _world.mapBytes();
+        uint64_t size = _world.mapColumns() * GameWorld::MapStride;
+        _inputLog.begin(_recordSeed, _level ? assets.levelPath : "level.png",
+            InputLog::hashMap(bytes, bytes ? size : 0), InputLog::hashSpawns(_spawns.get()), _world.mapColumns(),
+            _world.columnsPerUnit());
+        _world.setRecorder(&_inputLog);
     }
-
-    next = 0;
-    for(auto &c : {
-        glm::vec2(0.5f, 0.0f),
-        glm::vec2(5.0f, 0.0f),
-    })
+    else
     {
-        _enemies[next].used = true;
-        _enemies[next].position = c;
-        next++;
+        // Rewinding would desync the log, so it is only offered when not recording.
+        _simulation.setRewind(&_rewind);
+        input()->addPressedCallback(GLFW_KEY_BACKSPACE, [this](int key, int mods) {
+            _simulation.setRewinding(true);
+            return true;
+        });
+        input()->addReleasedCallback(GLFW_KEY_BACKSPACE, [this](int key, int mods) {
+            _simulation.setRewinding(false);
+            return true;
+        });
     }
+    _world.snapshot(_snapshot);
+    _simulation.start();
 
     _background->setShaderCallback([this](lithium::Renderable* r, lithium::ShaderProgram* sp) {
-        sp->setUniform("u_camera", _camera2d);
-        sp->setUniform("u_playerPos", _playerPos);
-
-        for(int index=0; index < 10; ++index)
-        {
-            auto& p = _playerProjectiles[index];
-            if(p.inactive && p.used == false)
-            {
-                continue;
-            }
-            p.inactive = false;
-            const std::string label = "u_projectiles[" + std::to_string(index) + "]";
-            sp->setUniform(label + ".used", p.used);
-            sp->setUniform(label + ".position", p.position);
-            p.inactive = !p.used;
-        }
-        for(int index=0; index < 10; ++index)
-        {
-            auto& c = _collectables[index];
-            if(c.inactive && c.used == false)
-            {
-                continue;
-            }
-            c.inactive = false;
-            const std::string label = "u_collectables[" + std::to_string(index) + "]";
-            sp->setUniform(label + ".used", c.used);
-            sp->setUniform(label + ".position", c.position);
-        }
-        for(int index=0; index < 10; ++index)
+        if(!_entityUniforms.isBoundTo(sp))
         {
-            auto& e = _enemies[index];
-            if(e.inactive && e.used == false)
-            {
-                continue;
-            }
-            e.inactive = false;
-            const std::string label = "u_enemies[" + std::to_string(index) + "]";
-            sp->setUniform(label + ".used", e.used);
-            sp->setUniform(label + ".position", e.position);
-            sp->setUniform(label + ".facingLeft", e.facingLeft);
-            sp->setUniform(label + ".chasingPlayer", e.chasingPlayer);
-            sp->setUniform(label + ".deathTimer", e.deathTimer);
+            _entityUniforms.bind(sp);
         }
-
-        sp->setUniform("u_shake", _shake);
+        glm::vec2 resolution = _pipeline->internalResolution();
+        _columnBins.build(_snapshot, resolution.x / resolution.y, std::max(static_cast<int>(resolution.x) / 16, 1));
+        _binTexture->upload(_columnBins.texels());
+        _binTexture->bind(GL_TEXTURE0 + EntityUniforms::BinTextureUnit);
+
+        TerrainColumns::Input terrain;
+        terrain.width = static_cast<int>(resolution.x);
+        terrain.aspect = resolution.x / resolution.y;
+        terrain.camera = _snapshot.camera2d.x;
+        terrain.time = _pipeline->time();
+        terrain.shake = _snapshot.shake;
+        // The world's bytes belong to the simulation thread; an edited map is read from the editor's side.
+        terrain.map = _map ? _map->bytes() : _world.mapBytes();
+        terrain.mapColumns = _world.mapColumns();
+        terrain.columnsPerUnit = _world.columnsPerUnit();
+        _terrainColumns.build(terrain);
+        _terrainTexture->upload(_terrainColumns.displacements());
+        _terrainTexture->bind(GL_TEXTURE0 + EntityUniforms::TerrainTextureUnit);
+        _entityUniforms.upload(_snapshot, _columnBins, resolution, _pipeline->time());
     });
 
     // Set the camera oirigin position and target.
@@ -182,20 +231,61 @@ App::App() : Application{"lithium-lab", glm::ivec2{1440, 800}, lithium::Applicat
     setMaxFps(120.0f);
 
     printf("%s\n", glGetString(GL_VERSION));
+
+    // Ends with the first update().
+    startup.phase("first frame");
 }
 
 App::~App() noexcept
 {
+    _simulation.stop();
+    _world.setRecorder(nullptr);
+    _mapSaver.wait();
+    MapSaver::Stats saves = _mapSaver.stats();
+    if(saves.saves + saves.failures > 0)
+    {
+        std::cout << "Saved level.png " << saves.saves << " times, " << saves.failures << " failed" << std::endl;
+    }
+#ifdef SUSJAM23_ALLOC_TRACKING
+    std::cout << _frameAllocations.allocatingFrames() << " frames allocated after warm-up" << std::endl;
+#endif
+#ifdef SUSJAM23_PROFILE
+    Profiler::printSummary(stdout);
+    Profiler::writeChromeTrace("susjam23_trace.json");
+#endif
+    if(!_recordPath.empty())
+    {
+        _inputLog.finish(_world.stateHash());
+        if(_inputLog.save(_recordPath))
+        {
+            std::cout << "Recorded " << _inputLog.header().tickCount << " ticks to " << _recordPath << std::endl;
+        }
+        else
+        {
+            std::cerr << "Failed to save recording " << _recordPath << std::endl;
+        }
+    }
     _pipeline = nullptr;
     _background = nullptr;
+    _binTexture = nullptr;
+    _terrainTexture = nullptr;
     _objects.clear();
 }
 
 void App::update(float dt)
 {
+    PROFILE_ZONE("frame");
+#ifdef SUSJAM23_ALLOC_TRACKING
+    uint64_t worst = _frameAllocations.worst().allocations;
+    const AllocTracker::Counts& allocated = _frameAllocations.frame();
+    if(_frameAllocations.worst().allocations > worst)
+    {
+        std::cerr << "Frame allocated " << allocated.allocations << " times, " << allocated.bytes << " bytes" << std::endl;
+    }
+#endif
     lithium::Updateable::update(dt);
     // Apply a rotation to the cube.
-    for(auto o : _objects)
+    for(const auto& o : _objects)
     {
         o->update(dt);
         /*o->setQuaternion(o->quaternion() * glm::angleAxis(0.5f * dt, glm::vec3(1,0,0))
@@ -214,201 +304,39 @@ void App::update(float dt)
 
     }
 
-    unsigned char* buf = _map->bytes();
-    size_t index = std::min(std::max(0, static_cast<int>((0.5f + _playerPos.x) / 4.0f * _map->width())), _map->width() - 1);
-
-    float height = static_cast<float>(buf[index * 4 + 0]) / 255.0f;
-    bool inWater = buf[index * 4 + 2] == 0xFF;
-
-    if(inWater && !_godMode)
     {
-        _playerPos.x -= glm::sign(_playerVel.x) * 0.7f;
-        _shakeTimer = 0.2f;
+        PROFILE_ZONE("simulation");
+        _simulation.read(_snapshot);
     }
 
-    static glm::vec2 cameraTarget{0.0f, 0.0f};
-    cameraTarget.x = int(_playerPos.x + 0.5);
-    glm::vec2 dc = cameraTarget - _camera2d;
-    if(dc.x * dc.x + dc.y * dc.y < 0.000001f)
+    if(_map && _mapEditor.dirty())
     {
-        _camera2d = cameraTarget;
+        // Hand only the columns edited since the last frame to the simulation and the saver.
+        // The job carries the edited bytes and writes them into the world's copy.
+        _mapEditor.flush([this](const MapEditor::Span& span) {
+            const unsigned char* first = _map->bytes() + span.first * GameWorld::MapStride;
+            std::vector<unsigned char> columns(first, first + span.count * GameWorld::MapStride);
+            unsigned char* target = _worldMap.data() + span.first * GameWorld::MapStride;
+            _simulation.post([span, target, columns = std::move(columns)](GameWorld& world) {
+                std::copy(columns.begin(), columns.end(), target);
+                world.mapChanged(span.first, span.count);
+            });
+            _mapSaver.changed(span);
+        });
     }
-    else
-    {
-        _camera2d = glm::mix(_camera2d, cameraTarget, 2.0f * dt);
-    }
-
-    for(auto& p : _playerProjectiles)
-    {
-        if(p.used)
-        {
-            p.position += p.velocity * dt;
-            if(abs(p.position.x - _playerPos.x) > 4.0f)
-            {
-                p.inactive = false;
-                p.used = false;
-            }
-
-            for(auto& e : _enemies)
-            {
-                if(e.used)
-                {
-                    glm::vec2 delta = glm::vec2(p.position.x, p.position.y) - e.position;
-                    if(delta.x * delta.x + delta.y * delta.y < 0.005f)
-                    {
-                        p.inactive = false;
-                        p.used = false;
-                        e.health -= 1;
-                        break;
-                    }
-                }
-            }
-        }
-    }
-
-    for(auto& c : _collectables)
-    {
-        if(c.used)
-        {
-            if(c.picked)
-            {
-                c.picking -= dt;
-                c.position.y += 1.0f * dt;
-                if(c.picking <= 0)
-                {
-                    c.picking = 0.0f;
-                    c.picked = false;
-                    c.used = false;
-                }
-            }
-            else if(!_godMode)
-            {
-                float dx = c.position.x - _playerPos.x;
-                float dy = c.position.y - _playerPos.y + 0.1f;
-                if(abs(dx) < 0.05f && abs(dy) < 0.25f)
-                {
-                    c.picked = true;
-                    c.picking = 0.16f;
-                }
-            }
-        }
-    }
-
-    for(auto& e : _enemies)
-    {
-        if(e.used)
-        {
-            glm::vec2 delta = glm::vec2(_playerPos.x, _playerPos.y) - e.position;
-            if(!_godMode && delta.x * delta.x + delta.y * delta.y < 0.005f)
-            {
-                _shakeTimer = 0.3f;
-                e.used = false;
-                continue;
-            }
-            float dx{};
-            if(e.health <= 0)
-            {
-                if(e.deathTimer == 0.0f)
-                {
-                    e.deathTimer = 0.4f;
-                }
-                e.deathTimer -= dt;
-                if(e.deathTimer <= 0)
-                {
-                    e.used = false;
-                }
-            }
-            else if(e.chasingPlayer)
-            {
-                dx = _playerPos.x - e.position.x;
-                e.position.x += glm::sign(dx) * 0.4f * dt;
-            }
-            else
-            {
-                dx = sin(time()) * 0.2f;
-                e.position.x += dx * dt;
-            }
-            e.facingLeft = dx < 0;
-
-            float pdx = _playerPos.x - e.position.x;
-            if(e.facingLeft && pdx > -0.5f && pdx < 0)
-            {
-                e.chasingPlayer = !_godMode;
-            }
-        }
-    }
-
-    if(_keyCache->isPressed(GLFW_KEY_A) && _playerVel.x <= 0.0f)
-    {
-        _playerVel.x -= 1.8f * dt;
-        _playerVel.x = std::max(_playerVel.x, -1.0f);
-        _playerPos.z = -1.0f;
-    }
-    else if(_keyCache->isPressed(GLFW_KEY_D) && _playerVel.x >= 0.0f)
-    {
-        _playerVel.x += 1.8f * dt;
-        _playerVel.x = std::min(_playerVel.x, 1.0f);
-        _playerPos.z = 1.0f;
-    }
-    else
-    {
-        _playerVel.x = glm::mix(_playerVel.x, 0.0f, 12.0f * dt);
-        if(_playerVel.x * _playerVel.x < 0.01f)
-        {
-            _playerVel.x = 0.0f;
-        }
-    }
-
-    if(_keyCache->isPressed(GLFW_KEY_SPACE))
-    {
-        if(_playerJumpState == JumpState::GROUNDED)
-        {
-            _playerJumpState = JumpState::JUMPING;
-            _playerVel.y = 2.0f;
-        }
-    }
-
-    _playerPos.x += _playerVel.x * dt;
-    _playerPos.y += _playerVel.y * dt;
 
-    if(_playerPos.x < -0.94f)
-    {
-        _playerPos.x = -0.94f;
-        if(_playerVel.x < 0)
-        {
-            _shakeTimer = -_playerVel.x * 0.32f;
-            _playerVel.x = -_playerVel.x;
-        }
-    }
-
-    if(_playerPos.y > 0 && _playerJumpState != JumpState::GROUNDED)
-    {
-        _playerVel.y -= 10.0f * dt;
-        if(_playerVel.y < 0)
-        {
-            _playerJumpState = JumpState::FALLING;
-        }
-    }
-    else
+    if(_saveRequested)
     {
-        if(!_playerCrawling)
-            _playerPos.y = 0.0f;
-        _playerVel.y = 0.0f;
-        _playerJumpState = JumpState::GROUNDED;
+        // Only queues the save; encoding and writing happen on the saver's thread.
+        PROFILE_ZONE("save");
+        _saveRequested = false;
+        _mapSaver.save();
     }
 
-    if(_playerJumpState == JumpState::GROUNDED)
+    if(_level)
     {
-        if(_playerCrawling)
-        {
-            _playerPos.y -= 0.5f * dt;
-            _playerPos.y = std::max(_playerPos.y, -0.04f);
-        }
-        else
-        {
-            _playerPos.y += 0.5f * dt;
-            _playerPos.y = std::min(_playerPos.y, 0.0f);
-        }
+        // Keep a few screens of columns either side of the camera resident.
+        _level->page(_world.mapColumn(_snapshot.camera2d.x), static_cast<uint64_t>(_level->columnsPerUnit() * 8.0f));
     }
 
     if(_keyCache->isPressed(GLFW_KEY_UP))
@@ -420,17 +348,6 @@ void App::update(float dt)
         _cameraPitch -= glm::pi<float>() * 0.5f * dt;
     }
 
-    if(_shakeTimer > 0)
-    {
-        _shakeTimer -= dt;
-        _shake = (rand() % 1000000) * 0.00001f;
-        if(_shakeTimer <= 0)
-        {
-            _shake = 0.0f;
-            _shakeTimer = 0.0f;
-        }
-    }
-
     static const float cameraRadius = 8.0f;
 
     glm::vec3 cameraPosition;
@@ -441,7 +358,17 @@ void App::update(float dt)
     _pipeline->setTime(time());
 
     _pipeline->camera()->setPosition(cameraPosition);
-    _pipeline->render();
+    {
+        PROFILE_ZONE("render");
+        _pipeline->render();
+    }
+
+    if(_startup)
+    {
+        _startup->finish();
+        _startup->printBreakdown(stdout);
+        _startup = nullptr;
+    }
 }
 
 void App::onWindowSizeChanged(int width, int height)
@@ -451,6 +378,10 @@ void App::onWindowSizeChanged(int width, int height)
 
 bool App::manipMap(int mods, int amount, int bit)
 {
+    if(!_map || !_recordPath.empty())
+    {
+        return false;
+    }
     bool copy{false};
     if(mods & GLFW_MOD_CONTROL)
     {
@@ -462,34 +393,26 @@ bool App::manipMap(int mods, int amount, int bit)
     }
     if(mods & GLFW_MOD_ALT)
     {
-        unsigned char* buf = _map->bytes();
-        size_t index = static_cast<int>((0.5f + _playerPos.x) / 4.0f * _map->width());
-        if(index < 0 || index >= _map->width())
+        size_t index = _world.mapColumn(_snapshot.playerPos.x);
+        if(index >= _mapEditor.columns())
         {
             return false;
         }
+        int value = _mapEditor.get(index, bit);
         if(copy)
         {
-            size_t otherIndex = index + (amount < 0 ? -1 : 1);
-            if(otherIndex < 0 || otherIndex >= _map->width())
+            bool left = amount < 0;
+            if(left ? index == 0 : index + 1 >= _mapEditor.columns())
             {
                 return false;
             }
-            buf[index * 4 + bit] = buf[otherIndex * 4 + bit];
+            value = _mapEditor.get(left ? index - 1 : index + 1, bit);
         }
         else
         {
-            if(amount < 0)
-            {
-                amount = std::max(amount, -static_cast<int>(buf[index * 4 + bit]));
-            }
-            else
-            {
-                amount = std::min(amount, 255 - static_cast<int>(buf[index * 4 + bit]));
-            }
-            buf[index * 4 + bit] = buf[index * 4 + bit] + amount;
+            value = std::clamp(value + amount, 0, 255);
         }
-        _map->reloadBytes();
+        _mapEditor.set(index, bit, static_cast<unsigned char>(value));
     }
     return true;
 }
\ No newline at end of file
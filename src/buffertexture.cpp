@@ -0,0 +1,43 @@
+#include "buffertexture.h"
+
+#include <algorithm>
+
+BufferTexture::BufferTexture(GLenum internalFormat) : _internalFormat{internalFormat}
+{
+    glGenBuffers(1, &_buffer);
+    glGenTextures(1, &_texture);
+}
+
+BufferTexture::~BufferTexture() noexcept
+{
+    glDeleteTextures(1, &_texture);
+    glDeleteBuffers(1, &_buffer);
+}
+
+void BufferTexture::upload(const void* data, size_t size)
+{
+    glBindBuffer(GL_TEXTURE_BUFFER, _buffer);
+    if(size > _capacity)
+    {
+        _capacity = std::max(size, _capacity * 2);
+        glBufferData(GL_TEXTURE_BUFFER, _capacity, nullptr, GL_STREAM_DRAW);
+        glBindTexture(GL_TEXTURE_BUFFER, _texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, _internalFormat, _buffer);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+    else
+    {
+        // Orphan last frame's storage so the driver does not stall on it.
+        glBufferData(GL_TEXTURE_BUFFER, _capacity, nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    _bytesUploaded = size;
+}
+
+void BufferTexture::bind(GLenum textureUnit)
+{
+    glActiveTexture(textureUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, _texture);
+    glActiveTexture(GL_TEXTURE0);
+}
@@ -0,0 +1,39 @@
+#include "activationregions.h"
+
+#include <algorithm>
+
+void ActivationRegions::setMap(size_t columns, float columnsPerUnit)
+{
+    _columns = columns;
+    _columnsPerUnit = columnsPerUnit;
+    _regions = std::max<size_t>((columns + RegionColumns - 1) / RegionColumns, 1);
+    _first = 1;
+    _last = 0;
+}
+
+size_t ActivationRegions::region(float x) const
+{
+    // In doubles, like Terrain::column: a float runs out of precision for column numbers past 2^24.
+    double column = (static_cast<double>(x) + 0.5) * _columnsPerUnit;
+    if(!(column > 0.0) || _columns == 0)
+    {
+        return 0;
+    }
+    if(column >= static_cast<double>(_columns))
+    {
+        return _regions - 1;
+    }
+    return static_cast<size_t>(column) / RegionColumns;
+}
+
+void ActivationRegions::range(float cameraX, size_t& first, size_t& last) const
+{
+    if(_radius <= 0.0f)
+    {
+        first = 0;
+        last = _regions - 1;
+        return;
+    }
+    first = region(cameraX - _radius);
+    last = region(cameraX + _radius);
+}
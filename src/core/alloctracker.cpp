@@ -0,0 +1,184 @@
+#include "alloctracker.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    // Plain zero-initialized thread locals, so the hooks never run a TLS
+    // constructor or allocate themselves.
+    thread_local uint64_t allocations;
+    thread_local uint64_t bytes;
+    thread_local uint64_t frees;
+}
+
+AllocTracker::Counts AllocTracker::thread()
+{
+    return Counts{allocations, bytes, frees};
+}
+
+const AllocTracker::Counts& AllocTracker::Frames::frame()
+{
+    Counts now = thread();
+    _last = now - _start;
+    _start = now;
+    ++_frames;
+    if(steady() && _last.allocations > 0)
+    {
+        ++_allocatingFrames;
+        if(_last.allocations > _worst.allocations)
+        {
+            _worst = _last;
+        }
+    }
+    return _last;
+}
+
+#ifdef SUSJAM23_ALLOC_TRACKING
+
+namespace
+{
+    void* allocate(std::size_t size)
+    {
+        ++allocations;
+        bytes += size;
+        return std::malloc(size ? size : 1);
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        ++allocations;
+        bytes += size;
+        std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+        return _aligned_malloc(size ? size : 1, align);
+#else
+        // aligned_alloc wants the size to be a multiple of the alignment.
+        return std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+    }
+
+    void release(void* p)
+    {
+        if(p)
+        {
+            ++frees;
+            std::free(p);
+        }
+    }
+
+    void releaseAligned(void* p)
+    {
+        if(p)
+        {
+            ++frees;
+#ifdef _WIN32
+            _aligned_free(p);
+#else
+            std::free(p);
+#endif
+        }
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    void* p = allocate(size);
+    if(p == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* p = allocateAligned(size, alignment);
+    if(p == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* p) noexcept
+{
+    release(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    release(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    release(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    release(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    release(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    release(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    releaseAligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    releaseAligned(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    releaseAligned(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept
+{
+    releaseAligned(p);
+}
+
+#endif
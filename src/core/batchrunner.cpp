@@ -0,0 +1,125 @@
+#include "batchrunner.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    // Distance from the end of the map that counts as reaching it.
+    const float FinishMargin{0.05f};
+
+    class Driver
+    {
+    public:
+        Driver(BatchRunner::Bot bot, uint64_t seed) : _bot{bot}, _random{seed}
+        {
+            _lookahead = 0.1f + 0.2f * _random.below(1000) / 1000.0f;
+        }
+
+        GameWorld::Input next(const GameWorld& world)
+        {
+            return _bot == BatchRunner::Bot::RUNNER ? runner(world) : random();
+        }
+
+    private:
+        GameWorld::Input runner(const GameWorld& world)
+        {
+            GameWorld::Input input;
+            input.right = true;
+            float x = world.playerPos().x;
+            bool enemyAhead{false};
+            const glm::vec2* positions = world.enemies().positions();
+            for(size_t i = 0; i < world.enemies().awake() && !enemyAhead; ++i)
+            {
+                float dx = positions[i].x - x;
+                enemyAhead = dx > 0.0f && dx < _lookahead * 2.0f;
+            }
+            input.jump = enemyAhead || world.terrain().waterBetween(x, x + _lookahead);
+            input.fire = enemyAhead && world.ticks() % 20 == 0;
+            return input;
+        }
+
+        GameWorld::Input random()
+        {
+            if(_hold-- <= 0)
+            {
+                uint32_t direction = _random.below(20);
+                _held = GameWorld::Input{};
+                _held.right = direction < 14;
+                _held.left = direction >= 17;
+                _held.jump = _random.below(10) < 3;
+                _hold = 30 + static_cast<int>(_random.below(60));
+            }
+            GameWorld::Input input = _held;
+            input.fire = _random.below(60) == 0;
+            return input;
+        }
+
+        BatchRunner::Bot _bot;
+        Random _random;
+        float _lookahead{0.2f};
+        GameWorld::Input _held;
+        int _hold{0};
+    };
+}
+
+BatchRunner::BatchRunner(std::shared_ptr<ThreadPool> threadPool) : _threadPool{threadPool}
+{
+    if(_threadPool == nullptr)
+    {
+        _threadPool = std::make_shared<ThreadPool>();
+    }
+}
+
+BatchRunner::Result BatchRunner::play(const unsigned char* map, size_t columns, float columnsPerUnit,
+    const Config& config, int instance)
+{
+    uint64_t seed = config.seed + static_cast<uint64_t>(instance) * 0x9E3779B97F4A7C15ull;
+    GameWorld world;
+    world.setMap(map, columns, columnsPerUnit);
+    world.setSeed(seed);
+    world.setSpawns(config.spawns);
+    Driver driver{config.bot, seed ^ 0xB07ull};
+
+    Result result;
+    float finish = world.mapEnd() - FinishMargin;
+    while(world.ticks() < config.maxTicks)
+    {
+        world.step(GameWorld::FixedTimestep, driver.next(world));
+        if(world.playerPos().x >= finish)
+        {
+            result.completed = true;
+            break;
+        }
+    }
+    result.ticks = world.ticks();
+    result.reachedX = world.playerPos().x;
+    result.counters = world.counters();
+    return result;
+}
+
+BatchRunner::Report BatchRunner::run(const unsigned char* map, size_t columns, float columnsPerUnit, const Config& config)
+{
+    _results.assign(static_cast<size_t>(std::max(config.instances, 0)), Result{});
+
+    // Instances run thousands of ticks each, so the pool's shared index
+    // counter balances them with one atomic increment per instance.
+    auto start = std::chrono::steady_clock::now();
+    _threadPool->parallelFor(_results.size(), [&](size_t i) {
+        _results[i] = play(map, columns, columnsPerUnit, config, static_cast<int>(i));
+    });
+
+    Report report;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.threads = _threadPool->concurrency();
+    report.instances = static_cast<int>(_results.size());
+    for(const Result& result : _results)
+    {
+        report.completed += result.completed ? 1 : 0;
+        report.ticks += result.ticks;
+        report.waterHits += result.counters.waterHits;
+        report.enemyHits += result.counters.enemyHits;
+        report.collected += result.counters.collected;
+    }
+    return report;
+}
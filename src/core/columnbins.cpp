@@ -0,0 +1,102 @@
+#include "columnbins.h"
+
+#include <algorithm>
+#include <cmath>
+
+template <typename Visitor>
+void ColumnBins::forEachItem(const WorldSnapshot& world, Visitor&& visit) const
+{
+    // The shader offsets every entity by 0.5 before comparing it to st.
+    for(const glm::vec2& p : world.projectilePositions)
+    {
+        visit(ProjectileRadius, Texel{p.x + 0.5f, p.y + 0.5f, 0.0f, static_cast<float>(PROJECTILE)});
+    }
+
+    for(size_t i = 0; i < world.enemies.size(); ++i)
+    {
+        const glm::vec2& p = world.enemyPositions[i];
+        const auto& e = world.enemies[i];
+        int flags = ENEMY | (e.chasingPlayer ? ChasingFlag : 0) | (e.facingLeft ? FacingLeftFlag : 0);
+        visit(EnemyRadius, Texel{p.x + 0.5f, p.y + 0.5f, e.deathTimer, static_cast<float>(flags)});
+    }
+
+    for(const glm::vec2& p : world.collectablePositions)
+    {
+        visit(CollectableRadius, Texel{p.x + 0.5f, p.y + 0.5f, 0.0f, static_cast<float>(COLLECTABLE)});
+    }
+
+    for(size_t i = 0; i < world.particlePositions.size(); ++i)
+    {
+        const glm::vec2& p = world.particlePositions[i];
+        int flags = PARTICLE | world.particleKinds[i] << ParticleKindShift;
+        visit(ParticleRadius, Texel{p.x + 0.5f, p.y + 0.5f, world.particleFades[i], static_cast<float>(flags)});
+    }
+}
+
+void ColumnBins::build(const WorldSnapshot& world, float aspect, int binCount)
+{
+    _binCount = std::max(binCount, 1);
+    _origin = world.camera2d.x - 0.5f;
+    _binWidth = aspect / _binCount;
+
+    _texels.assign(_binCount, Texel{0.0f, 0.0f, 0.0f, 0.0f});
+
+    // Counting pass: how many items land in each bin.
+    int particleTexels = 0;
+    forEachItem(world, [this, &particleTexels](float radius, const Texel& texel) {
+        int begin, end;
+        range(texel.x, radius, begin, end);
+        for(int bin = begin; bin < end; ++bin)
+        {
+            _texels[bin].y += 1.0f;
+        }
+        if((static_cast<int>(texel.w) & 3) == PARTICLE)
+        {
+            particleTexels += end - begin;
+        }
+    });
+
+    int next = _binCount;
+    _cursor.resize(_binCount);
+    for(int bin = 0; bin < _binCount; ++bin)
+    {
+        _texels[bin].x = static_cast<float>(next);
+        _cursor[bin] = next;
+        next += count(bin);
+    }
+    // Particles come and go in bursts; room for as many as the snapshot can
+    // hold, each across two bins at most, keeps a burst from growing this.
+    _texels.reserve(next - particleTexels + 2 * world.particlePositions.capacity());
+    _texels.resize(next);
+
+    // Fill pass, in the same order as the counting pass.
+    forEachItem(world, [this](float radius, const Texel& texel) {
+        int begin, end;
+        range(texel.x, radius, begin, end);
+        for(int bin = begin; bin < end; ++bin)
+        {
+            _texels[_cursor[bin]++] = texel;
+        }
+    });
+}
+
+int ColumnBins::binOf(float x) const
+{
+    int bin = static_cast<int>(std::floor((x - _origin) / _binWidth));
+    return std::min(std::max(bin, 0), _binCount - 1);
+}
+
+void ColumnBins::range(float x, float radius, int& begin, int& end) const
+{
+    // Pad by a hair so the shader's own float math never lands outside.
+    float pad = radius + _binWidth * 0.01f;
+    float lo = (x - pad - _origin) / _binWidth;
+    float hi = (x + pad - _origin) / _binWidth;
+    if(hi < 0.0f || lo >= _binCount)
+    {
+        begin = end = 0;
+        return;
+    }
+    begin = std::max(static_cast<int>(std::floor(lo)), 0);
+    end = std::min(static_cast<int>(std::floor(hi)) + 1, _binCount);
+}
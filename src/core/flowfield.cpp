@@ -0,0 +1,71 @@
+#include "flowfield.h"
+
+#include <algorithm>
+
+void FlowField::build(const Terrain& terrain)
+{
+    _columns = terrain.columns();
+    _reach.resize(std::min(_columns, WindowColumns));
+    _target = std::min(_target, _columns > 0 ? _columns - 1 : 0);
+    _begin = windowFor(_target);
+    update(terrain, _begin, _reach.size());
+}
+
+void FlowField::setTarget(const Terrain& terrain, size_t column)
+{
+    _target = column;
+    size_t begin = windowFor(column);
+    size_t moved = begin > _begin ? begin - _begin : _begin - begin;
+    if(moved > _reach.size() / 4)
+    {
+        _begin = begin;
+        update(terrain, _begin, _reach.size());
+    }
+}
+
+size_t FlowField::windowFor(size_t column) const
+{
+    size_t half = _reach.size() / 2;
+    return std::min(column > half ? column - half : 0, _columns - _reach.size());
+}
+
+void FlowField::update(const Terrain& terrain, size_t first, size_t count)
+{
+    // Only the window is kept; edits elsewhere are picked up when it moves there.
+    size_t columns = _reach.size();
+    size_t lo = std::max(first, _begin) - _begin;
+    size_t hi = std::min(first + count, end());
+    if(hi <= _begin || lo >= hi - _begin)
+    {
+        return;
+    }
+    hi -= _begin;
+
+    // Edges into and out of the edited columns changed. Reach going right is
+    // derived right to left, and keeps spreading left past the edit for as
+    // long as a column's reach actually changes.
+    size_t last = std::min(hi, columns - 1);
+    for(size_t c = last + 1; c-- > 0;)
+    {
+        uint32_t reach = c + 1 < columns && passable(terrain, _begin + c, _begin + c + 1) ? _reach[c + 1].right
+            : static_cast<uint32_t>(c);
+        if(c + 1 < lo && reach == _reach[c].right)
+        {
+            break;
+        }
+        _reach[c].right = reach;
+    }
+
+    // And reach going left, left to right.
+    size_t begin = lo > 0 ? lo - 1 : 0;
+    for(size_t c = begin; c < columns; ++c)
+    {
+        uint32_t reach = c > 0 && passable(terrain, _begin + c, _begin + c - 1) ? _reach[c - 1].left
+            : static_cast<uint32_t>(c);
+        if(c > hi && reach == _reach[c].left)
+        {
+            break;
+        }
+        _reach[c].left = reach;
+    }
+}
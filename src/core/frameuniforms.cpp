@@ -0,0 +1,20 @@
+#include "frameuniforms.h"
+
+#include "columnbins.h"
+
+std::string frameDeclarations()
+{
+    std::string out;
+    out += shaderlayout::declareConstant("PROJECTILE", static_cast<int>(ColumnBins::PROJECTILE));
+    out += shaderlayout::declareConstant("ENEMY", static_cast<int>(ColumnBins::ENEMY));
+    out += shaderlayout::declareConstant("COLLECTABLE", static_cast<int>(ColumnBins::COLLECTABLE));
+    out += shaderlayout::declareConstant("PARTICLE", static_cast<int>(ColumnBins::PARTICLE));
+    out += shaderlayout::declareConstant("PARTICLE_KIND_SHIFT", ColumnBins::ParticleKindShift);
+    out += shaderlayout::declareConstant("CHASING", ColumnBins::ChasingFlag);
+    out += shaderlayout::declareConstant("PROJECTILE_RADIUS", ColumnBins::ProjectileRadius);
+    out += shaderlayout::declareConstant("ENEMY_RADIUS", ColumnBins::EnemyRadius);
+    out += shaderlayout::declareConstant("PARTICLE_RADIUS", ColumnBins::ParticleRadius);
+    out += "\n";
+    out += shaderlayout::declareBlock("Frame", FrameFields);
+    return out;
+}
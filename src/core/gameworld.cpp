@@ -0,0 +1,799 @@
+#include "gameworld.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "inputlog.h"
+#include "profiler.h"
+#include "worldsnapshot.h"
+
+namespace
+{
+    class StateHash
+    {
+    public:
+        template <typename T>
+        void add(const T& value)
+        {
+            unsigned char bytes[sizeof(T)];
+            std::memcpy(bytes, &value, sizeof(T));
+            for(unsigned char b : bytes)
+            {
+                _hash = (_hash ^ b) * 0x100000001B3ull;
+            }
+        }
+
+        uint64_t value() const
+        {
+            return _hash;
+        }
+
+    private:
+        uint64_t _hash{0xCBF29CE484222325ull};
+    };
+
+    template <typename T>
+    void appendValue(std::vector<unsigned char>& out, const T& value)
+    {
+        size_t offset = out.size();
+        out.resize(offset + sizeof(T));
+        std::memcpy(out.data() + offset, &value, sizeof(T));
+    }
+
+    template <typename T>
+    bool readValue(const unsigned char*& data, const unsigned char* end, T& value)
+    {
+        if(static_cast<size_t>(end - data) < sizeof(T))
+        {
+            return false;
+        }
+        std::memcpy(&value, data, sizeof(T));
+        data += sizeof(T);
+        return true;
+    }
+
+    /* Appends the table entries in [first, last) that pool's entities came from. */
+    template <typename State>
+    void collectEntries(const EntityPool<State>& pool, uint32_t first, uint32_t last, std::vector<uint32_t>& out)
+    {
+        for(size_t i = 0; i < pool.size(); ++i)
+        {
+            uint32_t entry = pool.infos()[i].entry;
+            if(entry != EntityInfo::NoEntry && entry >= first && entry < last)
+            {
+                out.push_back(entry);
+            }
+        }
+    }
+
+    /* Frees the sleepers streamed in from outside table entries [first, last). */
+    template <typename State>
+    void evictSleepers(EntityPool<State>& pool, uint32_t first, uint32_t last)
+    {
+        // Back to front, so removing only moves in sleepers already checked.
+        for(size_t i = pool.size(); i-- > pool.awake();)
+        {
+            uint32_t entry = pool.infos()[i].entry;
+            if(entry != EntityInfo::NoEntry && (entry < first || entry >= last))
+            {
+                pool.removeAt(i);
+            }
+        }
+    }
+}
+
+GameWorld::GameWorld()
+{
+    // Shots are capped, so their storage is sized once and stepping never
+    // grows it. Hits per tick are few.
+    _projectiles.reserve(MaxProjectiles);
+    _scratchXs.reserve(MaxProjectiles);
+    _scratchHeights.reserve(MaxProjectiles);
+    _hits.reserve(64);
+    _liveEntries.reserve(64);
+    _sleepingCollectables.reset(_activation.regions());
+    _sleepingEnemies.reset(_activation.regions());
+}
+
+void GameWorld::setMap(const unsigned char* bytes, size_t columns, float columnsPerUnit)
+{
+    _mapBytes = bytes;
+    _mapColumns = columns;
+    _columnsPerUnit = columnsPerUnit > 0.0f ? columnsPerUnit : columns / LegacyLevelUnits;
+    _terrain.build(bytes, columns, MapStride, _columnsPerUnit);
+    _flowField.build(_terrain);
+
+    // Regions follow the map, so start over with everyone awake.
+    _activation.setMap(columns, _columnsPerUnit);
+    _collectables.wakeAll();
+    _enemies.wakeAll();
+    _sleepingCollectables.reset(_activation.regions());
+    _sleepingEnemies.reset(_activation.regions());
+}
+
+GameWorld::Collectables::Handle GameWorld::spawnCollectable(const glm::vec2& position)
+{
+    return _collectables.spawn(position, Collectable{}, EntityInfo{position, _ticks});
+}
+
+GameWorld::Enemies::Handle GameWorld::spawnEnemy(const glm::vec2& position)
+{
+    return _enemies.spawn(position, Enemy{}, EntityInfo{position, _ticks});
+}
+
+GameWorld::Projectiles::Handle GameWorld::fire()
+{
+    if(_projectiles.size() >= MaxProjectiles)
+    {
+        return Projectiles::InvalidHandle;
+    }
+    glm::vec2 position{_playerPos.x, _playerPos.y};
+    return _projectiles.spawn(position, Projectile{glm::vec2(_playerPos.z * 1.6f, 0.0f), _terrain.height(position.x)},
+        EntityInfo{position, _ticks});
+}
+
+void GameWorld::setSpawns(const SpawnTable* spawns)
+{
+    _spawns = spawns;
+    _spawnedBegin = _spawnedEnd = 0;
+    if(spawns != nullptr)
+    {
+        // Room for a small level's spawns up front keeps streaming them off the heap.
+        size_t room = std::min(spawns->size(), MaxReservedSpawns);
+        _collectables.reserve(_collectables.size() + room);
+        _enemies.reserve(_enemies.size() + room);
+    }
+}
+
+int GameWorld::advance(float dt, const Input& input)
+{
+    // Drop time we cannot catch up on rather than spiralling after a stall.
+    _accumulator = std::min(_accumulator + dt, FixedTimestep * MaxStepsPerAdvance);
+    Input stepInput = input;
+    int steps{0};
+    while(_accumulator >= FixedTimestep)
+    {
+        step(FixedTimestep, stepInput);
+        stepInput.fire = false;
+        stepInput.shake = false;
+        _accumulator -= FixedTimestep;
+        ++steps;
+    }
+    return steps;
+}
+
+void GameWorld::step(float dt, const Input& input)
+{
+    if(_recorder != nullptr)
+    {
+        _recorder->record(input);
+    }
+    if(input.fire)
+    {
+        fire();
+    }
+    if(input.shake)
+    {
+        shakeFor(0.2f);
+    }
+    {
+        PROFILE_ZONE("water");
+        updateWater();
+    }
+    {
+        PROFILE_ZONE("camera");
+        updateCamera(dt);
+    }
+    {
+        PROFILE_ZONE("activation");
+        updateActivation();
+    }
+    {
+        PROFILE_ZONE("projectiles");
+        _enemyIndex.rebuild(_enemies.positions(), _enemies.awake());
+        updateProjectiles(dt);
+    }
+    {
+        PROFILE_ZONE("collectables");
+        updateCollectables(dt);
+    }
+    {
+        PROFILE_ZONE("enemies");
+        updateEnemies(dt);
+    }
+    {
+        PROFILE_ZONE("player");
+        updatePlayer(dt, input);
+    }
+    {
+        PROFILE_ZONE("particles");
+        _particles.update(dt);
+    }
+    updateShake(dt);
+    _time += dt;
+    ++_ticks;
+}
+
+void GameWorld::updateWater()
+{
+    // Everything crossed during the last move counts, not just the column
+    // the player ended up in.
+    bool inWater = _terrain.waterBetween(_playerPrevX, _playerPos.x);
+
+    if(inWater && !_godMode)
+    {
+        ++_counters.waterHits;
+        _particles.burst(ParticleSystem::SPLASH, glm::vec2(_playerPos.x, _playerPos.y));
+        _playerPos.x -= glm::sign(_playerVel.x) * 0.7f;
+        _shakeTimer = 0.2f;
+    }
+}
+
+void GameWorld::updateCamera(float dt)
+{
+    glm::vec2 cameraTarget{static_cast<float>(int(_playerPos.x + 0.5)), 0.0f};
+    glm::vec2 dc = cameraTarget - _camera2d;
+    if(dc.x * dc.x + dc.y * dc.y < 0.000001f)
+    {
+        _camera2d = cameraTarget;
+    }
+    else
+    {
+        _camera2d = glm::mix(_camera2d, cameraTarget, 2.0f * dt);
+    }
+}
+
+void GameWorld::updateActivation()
+{
+    _activation.update(_camera2d.x, [this](size_t region) {
+        streamSpawns(region);
+        _sleepingCollectables.wake(_collectables, region, [](size_t) {});
+        _sleepingEnemies.wake(_enemies, region, [this](size_t index) {
+            // Patrollers sway by sin(time) * 0.2, so where one would be now has
+            // a closed form. Stopping at the water's edge has none; one that
+            // would have reached water stays where it fell asleep.
+            glm::vec2& position = _enemies.positions()[index];
+            float x = position.x + 0.2f * (std::cos(_enemies.infos()[index].sleptAt) - std::cos(_time));
+            if(!_terrain.waterBetween(position.x, x))
+            {
+                position.x = x;
+            }
+            _enemies.states()[index].facingLeft = std::sin(_time) < 0.0f;
+        });
+    });
+    evictSpawns();
+}
+
+void GameWorld::streamSpawns(size_t region)
+{
+    if(_spawns == nullptr)
+    {
+        return;
+    }
+    size_t first, last;
+    if(_spawnedBegin == _spawnedEnd)
+    {
+        first = region;
+        last = region + 1;
+    }
+    else if(region < _spawnedBegin)
+    {
+        first = region;
+        last = _spawnedBegin;
+    }
+    else if(region >= _spawnedEnd)
+    {
+        first = _spawnedEnd;
+        last = region + 1;
+    }
+    else
+    {
+        return;
+    }
+    _spawnedBegin = _spawnedBegin == _spawnedEnd ? first : std::min(_spawnedBegin, first);
+    _spawnedEnd = std::max(_spawnedEnd, last);
+
+    // An entity still awake when the run was trimmed past where it came from
+    // is alive; it is not spawned a second time.
+    uint32_t firstEntry = static_cast<uint32_t>(firstSpawn(first) - _spawns->entries());
+    uint32_t lastEntry = static_cast<uint32_t>(firstSpawn(last) - _spawns->entries());
+    _liveEntries.clear();
+    collectEntries(_collectables, firstEntry, lastEntry, _liveEntries);
+    collectEntries(_enemies, firstEntry, lastEntry, _liveEntries);
+    std::sort(_liveEntries.begin(), _liveEntries.end());
+    auto live = _liveEntries.begin();
+
+    for(uint32_t index = firstEntry; index < lastEntry; ++index)
+    {
+        const SpawnTable::Entry* entry = _spawns->entries() + index;
+        glm::vec2 position = SpawnTable::position(*entry);
+        if(live != _liveEntries.end() && *live == index)
+        {
+            ++live;
+            continue;
+        }
+        if(entry->type == SpawnTable::Type::COLLECTABLE)
+        {
+            _collectables.infos()[_collectables.indexOf(spawnCollectable(position))].entry = index;
+        }
+        else if(entry->type == SpawnTable::Type::ENEMY)
+        {
+            _enemies.infos()[_enemies.indexOf(spawnEnemy(position))].entry = index;
+        }
+    }
+}
+
+void GameWorld::evictSpawns()
+{
+    // Streaming keeps the awake regions spawned, so the run only shrinks toward them.
+    size_t begin = _activation.first() > KeptSpawnRegions ? _activation.first() - KeptSpawnRegions : 0;
+    size_t end = _activation.last() + 1 + KeptSpawnRegions;
+    if(_spawns == nullptr || _spawnedBegin == _spawnedEnd || (_spawnedBegin >= begin && _spawnedEnd <= end))
+    {
+        return;
+    }
+    _spawnedBegin = std::max(_spawnedBegin, begin);
+    _spawnedEnd = std::min(_spawnedEnd, end);
+
+    // Sleepers that came from entries outside the run go, wherever they
+    // wandered to. Awake ones stay in play until they fall asleep, when
+    // outsideSpawnedRun() frees them instead.
+    uint32_t first = static_cast<uint32_t>(firstSpawn(_spawnedBegin) - _spawns->entries());
+    uint32_t last = static_cast<uint32_t>(firstSpawn(_spawnedEnd) - _spawns->entries());
+    evictSleepers(_collectables, first, last);
+    evictSleepers(_enemies, first, last);
+    _sleepingCollectables.rebuild(_collectables, _activation);
+    _sleepingEnemies.rebuild(_enemies, _activation);
+}
+
+bool GameWorld::outsideSpawnedRun(const EntityInfo& info) const
+{
+    if(_spawns == nullptr || info.entry == EntityInfo::NoEntry)
+    {
+        return false;
+    }
+    return info.entry < static_cast<size_t>(firstSpawn(_spawnedBegin) - _spawns->entries())
+        || info.entry >= static_cast<size_t>(firstSpawn(_spawnedEnd) - _spawns->entries());
+}
+
+const SpawnTable::Entry* GameWorld::firstSpawn(size_t region) const
+{
+    // Entries are sorted by x, so a region's entries are one run found by bisection.
+    return std::partition_point(_spawns->entries(), _spawns->entries() + _spawns->size(),
+        [&](const SpawnTable::Entry& e) {
+            return _activation.region(SpawnTable::position(e).x) < region;
+        });
+}
+
+void GameWorld::updateProjectiles(float dt)
+{
+    glm::vec2* positions = _projectiles.positions();
+    Projectile* projectiles = _projectiles.states();
+    _scratchXs.resize(_projectiles.size());
+    _scratchHeights.resize(_projectiles.size());
+    for(size_t i = 0; i < _projectiles.size(); ++i)
+    {
+        positions[i] += projectiles[i].velocity * dt;
+        _scratchXs[i] = positions[i].x;
+    }
+    _terrain.heights(_scratchXs.data(), _scratchHeights.data(), _projectiles.size());
+
+    // Removal swaps the last shot into the hole, so walk from the back to keep
+    // the ground heights lined up with the dense indices.
+    for(size_t i = _projectiles.size(); i-- > 0;)
+    {
+        glm::vec2& position = positions[i];
+        // Shots fly level, so a hill rising in front of one ends it.
+        bool expired = std::abs(position.x - _playerPos.x) > 4.0f
+            || _scratchHeights[i] - projectiles[i].ground > ProjectileClearance;
+
+        // Enemies do not move until updateEnemies, so the index is current.
+        int hit = _enemyIndex.firstWithin(position, 0.005f, _enemies.positions());
+        if(hit >= 0)
+        {
+            expired = true;
+            _enemies.states()[hit].health -= 1;
+        }
+
+        if(expired)
+        {
+            // Shots that ran out of range end off screen without a mark.
+            if(hit >= 0 || _scratchHeights[i] - projectiles[i].ground > ProjectileClearance)
+            {
+                _particles.burst(ParticleSystem::IMPACT, position);
+            }
+            _projectiles.removeAt(i);
+        }
+    }
+}
+
+void GameWorld::updateCollectables(float dt)
+{
+    // Collect pickups first; they start rising on the next tick.
+    _hits.clear();
+    if(!_godMode)
+    {
+        _collectableIndex.rebuild(_collectables.positions(), _collectables.awake());
+        const glm::vec2* positions = _collectables.positions();
+        const Collectable* collectables = _collectables.states();
+        _collectableIndex.query(_playerPos.x - 0.05f, _playerPos.x + 0.05f, [&](uint32_t index) {
+            float dx = positions[index].x - _playerPos.x;
+            float dy = positions[index].y - _playerPos.y + 0.1f;
+            if(!collectables[index].picked && std::abs(dx) < 0.05f && std::abs(dy) < 0.25f)
+            {
+                _hits.push_back(_collectables.handles()[index]);
+            }
+        });
+    }
+
+    glm::vec2* positions = _collectables.positions();
+    Collectable* collectables = _collectables.states();
+    for(size_t i = 0; i < _collectables.awake();)
+    {
+        Collectable& c = collectables[i];
+        if(c.picked)
+        {
+            c.picking -= dt;
+            positions[i].y += 1.0f * dt;
+            if(c.picking <= 0)
+            {
+                _collectables.removeAt(i);
+                continue;
+            }
+        }
+        else
+        {
+            size_t region = _activation.region(positions[i].x);
+            if(!_activation.awake(region))
+            {
+                if(outsideSpawnedRun(_collectables.infos()[i]))
+                {
+                    _collectables.removeAt(i);
+                    continue;
+                }
+                _sleepingCollectables.sleep(_collectables, i, region, _time + dt);
+                continue;
+            }
+        }
+        ++i;
+    }
+
+    for(uint32_t handle : _hits)
+    {
+        size_t index = _collectables.indexOf(handle);
+        Collectable& c = _collectables.states()[index];
+        _particles.burst(ParticleSystem::COLLECT, _collectables.positions()[index]);
+        c.picked = true;
+        c.picking = 0.16f;
+        ++_counters.collected;
+    }
+}
+
+void GameWorld::updateEnemies(float dt)
+{
+    // Enemies touching the player vanish before anyone moves this tick.
+    if(!_godMode)
+    {
+        _hits.clear();
+        glm::vec2 player{_playerPos.x, _playerPos.y};
+        const glm::vec2* positions = _enemies.positions();
+        float radius = std::sqrt(0.005f) * 1.001f;
+        _enemyIndex.query(player.x - radius, player.x + radius, [&](uint32_t index) {
+            glm::vec2 delta = player - positions[index];
+            if(delta.x * delta.x + delta.y * delta.y < 0.005f)
+            {
+                _hits.push_back(_enemies.handles()[index]);
+            }
+        });
+        for(uint32_t handle : _hits)
+        {
+            ++_counters.enemyHits;
+            _shakeTimer = 0.3f;
+            _particles.burst(ParticleSystem::DEATH, _enemies.positions()[_enemies.indexOf(handle)]);
+            _enemies.despawn(handle);
+        }
+    }
+
+    // One field rooted at the player serves every chaser.
+    size_t target = _terrain.column(_playerPos.x);
+    _flowField.setTarget(_terrain, target);
+
+    glm::vec2* positions = _enemies.positions();
+    Enemy* enemies = _enemies.states();
+    float patrol = std::sin(_time) * 0.2f;
+    for(size_t i = 0; i < _enemies.awake();)
+    {
+        Enemy& e = enemies[i];
+        glm::vec2& position = positions[i];
+        float dx{};
+        if(e.health <= 0)
+        {
+            if(e.deathTimer == 0.0f)
+            {
+                e.deathTimer = 0.4f;
+            }
+            e.deathTimer -= dt;
+            if(e.deathTimer <= 0)
+            {
+                ++_counters.kills;
+                _particles.burst(ParticleSystem::DEATH, position);
+                _enemies.removeAt(i);
+                continue;
+            }
+        }
+        else
+        {
+            float step;
+            if(e.chasingPlayer)
+            {
+                // Chasers the terrain cuts off from the player wait where they are; in the
+                // player's own column they close in directly.
+                dx = _playerPos.x - position.x;
+                size_t column = _terrain.column(position.x);
+                float direction = column == target ? glm::sign(dx) : static_cast<float>(_flowField.direction(column));
+                step = direction * 0.4f * dt;
+            }
+            else
+            {
+                dx = patrol;
+                step = dx * dt;
+            }
+            // Enemies stop at the water's edge instead of walking in.
+            if(!_terrain.inWater(position.x + step))
+            {
+                position.x += step;
+            }
+
+            // Chasers left that far behind give up and patrol once woken.
+            size_t region = _activation.region(position.x);
+            if(!_activation.awake(region))
+            {
+                if(outsideSpawnedRun(_enemies.infos()[i]))
+                {
+                    _enemies.removeAt(i);
+                    continue;
+                }
+                e.chasingPlayer = false;
+                _sleepingEnemies.sleep(_enemies, i, region, _time + dt);
+                continue;
+            }
+        }
+        e.facingLeft = dx < 0;
+
+        float pdx = _playerPos.x - position.x;
+        if(e.facingLeft && pdx > -0.5f && pdx < 0)
+        {
+            e.chasingPlayer = !_godMode;
+        }
+        ++i;
+    }
+}
+
+void GameWorld::updatePlayer(float dt, const Input& input)
+{
+    if(input.left && _playerVel.x <= 0.0f)
+    {
+        _playerVel.x -= 1.8f * dt;
+        _playerVel.x = std::max(_playerVel.x, -1.0f);
+        _playerPos.z = -1.0f;
+    }
+    else if(input.right && _playerVel.x >= 0.0f)
+    {
+        _playerVel.x += 1.8f * dt;
+        _playerVel.x = std::min(_playerVel.x, 1.0f);
+        _playerPos.z = 1.0f;
+    }
+    else
+    {
+        _playerVel.x = glm::mix(_playerVel.x, 0.0f, 12.0f * dt);
+        if(_playerVel.x * _playerVel.x < 0.01f)
+        {
+            _playerVel.x = 0.0f;
+        }
+    }
+
+    if(input.jump)
+    {
+        if(_playerJumpState == JumpState::GROUNDED)
+        {
+            _playerJumpState = JumpState::JUMPING;
+            _playerVel.y = 2.0f;
+        }
+    }
+
+    _playerPrevX = _playerPos.x;
+    _playerPos.x += _playerVel.x * dt;
+    _playerPos.y += _playerVel.y * dt;
+
+    if(_playerPos.x < -0.94f)
+    {
+        _playerPos.x = -0.94f;
+        if(_playerVel.x < 0)
+        {
+            _shakeTimer = -_playerVel.x * 0.32f;
+            _playerVel.x = -_playerVel.x;
+        }
+    }
+
+    if(_playerPos.y > 0 && _playerJumpState != JumpState::GROUNDED)
+    {
+        _playerVel.y -= 10.0f * dt;
+        if(_playerVel.y < 0)
+        {
+            _playerJumpState = JumpState::FALLING;
+        }
+    }
+    else
+    {
+        if(!input.crawl)
+            _playerPos.y = 0.0f;
+        _playerVel.y = 0.0f;
+        _playerJumpState = JumpState::GROUNDED;
+    }
+
+    if(_playerJumpState == JumpState::GROUNDED)
+    {
+        if(input.crawl)
+        {
+            _playerPos.y -= 0.5f * dt;
+            _playerPos.y = std::max(_playerPos.y, -0.04f);
+        }
+        else
+        {
+            _playerPos.y += 0.5f * dt;
+            _playerPos.y = std::min(_playerPos.y, 0.0f);
+        }
+    }
+}
+
+void GameWorld::updateShake(float dt)
+{
+    if(_shakeTimer > 0)
+    {
+        _shakeTimer -= dt;
+        _shake = _random.below(1000000) * 0.00001f;
+        if(_shakeTimer <= 0)
+        {
+            _shake = 0.0f;
+            _shakeTimer = 0.0f;
+        }
+    }
+}
+
+void GameWorld::snapshot(WorldSnapshot& out) const
+{
+    out.time = _time;
+    out.ticks = _ticks;
+    out.playerPos = _playerPos;
+    out.camera2d = _camera2d;
+    out.shake = _shake;
+
+    out.projectilePositions.reserve(MaxProjectiles);
+    out.projectileHandles.reserve(MaxProjectiles);
+    out.projectilePositions.assign(_projectiles.positions(), _projectiles.positions() + _projectiles.size());
+    out.projectileHandles.assign(_projectiles.handles(), _projectiles.handles() + _projectiles.size());
+
+    // Sleepers are off screen. Waking or streaming them in stays within the
+    // pools' capacity, so it does not grow the snapshot either.
+    out.enemyPositions.reserve(_enemies.capacity());
+    out.enemies.reserve(_enemies.capacity());
+    out.enemyHandles.reserve(_enemies.capacity());
+    out.collectablePositions.reserve(_collectables.capacity());
+    out.collectables.reserve(_collectables.capacity());
+    out.collectableHandles.reserve(_collectables.capacity());
+    out.enemyPositions.assign(_enemies.positions(), _enemies.positions() + _enemies.awake());
+    out.enemies.assign(_enemies.states(), _enemies.states() + _enemies.awake());
+    out.enemyHandles.assign(_enemies.handles(), _enemies.handles() + _enemies.awake());
+
+    out.collectablePositions.assign(_collectables.positions(), _collectables.positions() + _collectables.awake());
+    out.collectables.assign(_collectables.states(), _collectables.states() + _collectables.awake());
+    out.collectableHandles.assign(_collectables.handles(), _collectables.handles() + _collectables.awake());
+
+    out.particlePositions.reserve(_particles.capacity());
+    out.particleFades.reserve(_particles.capacity());
+    out.particleKinds.reserve(_particles.capacity());
+    out.particlePositions.resize(_particles.size());
+    out.particleFades.resize(_particles.size());
+    out.particleKinds.resize(_particles.size());
+    for(size_t i = 0; i < _particles.size(); ++i)
+    {
+        out.particlePositions[i] = _particles.position(i);
+        out.particleFades[i] = _particles.fade(i);
+        out.particleKinds[i] = _particles.kind(i);
+    }
+}
+
+void GameWorld::saveState(std::vector<unsigned char>& out) const
+{
+    appendValue(out, _accumulator);
+    appendValue(out, _time);
+    appendValue(out, _ticks);
+    appendValue(out, _playerPos);
+    appendValue(out, _playerPrevX);
+    appendValue(out, _playerVel);
+    appendValue(out, _playerJumpState);
+    appendValue(out, _camera2d);
+    appendValue(out, _shakeTimer);
+    appendValue(out, _shake);
+    appendValue(out, _random.state());
+    appendValue(out, _godMode);
+    appendValue(out, _counters);
+    appendValue(out, _spawnedBegin);
+    appendValue(out, _spawnedEnd);
+    _projectiles.write(out);
+    _collectables.write(out);
+    _enemies.write(out);
+}
+
+bool GameWorld::loadState(const unsigned char* data, size_t size)
+{
+    const unsigned char* end = data + size;
+    uint64_t random;
+    bool ok = readValue(data, end, _accumulator)
+        && readValue(data, end, _time)
+        && readValue(data, end, _ticks)
+        && readValue(data, end, _playerPos)
+        && readValue(data, end, _playerPrevX)
+        && readValue(data, end, _playerVel)
+        && readValue(data, end, _playerJumpState)
+        && readValue(data, end, _camera2d)
+        && readValue(data, end, _shakeTimer)
+        && readValue(data, end, _shake)
+        && readValue(data, end, random)
+        && readValue(data, end, _godMode)
+        && readValue(data, end, _counters)
+        && readValue(data, end, _spawnedBegin)
+        && readValue(data, end, _spawnedEnd)
+        && _projectiles.read(data, end)
+        && _collectables.read(data, end)
+        && _enemies.read(data, end);
+    if(ok)
+    {
+        _random.setSeed(random);
+        // Particles are not saved; ones from another moment would only hang in the air.
+        _particles.clear();
+        _activation.place(_camera2d.x);
+        _sleepingCollectables.rebuild(_collectables, _activation);
+        _sleepingEnemies.rebuild(_enemies, _activation);
+    }
+    return ok && data == end;
+}
+
+uint64_t GameWorld::stateHash() const
+{
+    StateHash hash;
+    hash.add(_time);
+    hash.add(_ticks);
+    hash.add(_playerPos);
+    hash.add(_playerPrevX);
+    hash.add(_playerVel);
+    hash.add(_playerJumpState);
+    hash.add(_camera2d);
+    hash.add(_shakeTimer);
+    hash.add(_shake);
+    hash.add(_random.state());
+    for(size_t i = 0; i < _projectiles.size(); ++i)
+    {
+        hash.add(_projectiles.positions()[i]);
+        hash.add(_projectiles.states()[i].velocity);
+        hash.add(_projectiles.states()[i].ground);
+    }
+    hash.add(_spawnedBegin);
+    hash.add(_spawnedEnd);
+    for(size_t i = 0; i < _collectables.size(); ++i)
+    {
+        hash.add(_collectables.positions()[i]);
+        hash.add(_collectables.states()[i].picked);
+        hash.add(_collectables.states()[i].picking);
+    }
+    for(size_t i = 0; i < _enemies.size(); ++i)
+    {
+        const Enemy& e = _enemies.states()[i];
+        hash.add(_enemies.positions()[i]);
+        hash.add(e.facingLeft);
+        hash.add(e.chasingPlayer);
+        hash.add(e.deathTimer);
+        hash.add(e.health);
+    }
+    return hash.value();
+}
@@ -0,0 +1,197 @@
+#include "inputlog.h"
+
+#include <cstdio>
+
+namespace
+{
+    enum InputBit : uint8_t
+    {
+        LEFT = 1,
+        RIGHT = 2,
+        JUMP = 4,
+        CRAWL = 8,
+        FIRE = 16,
+        SHAKE = 32
+    };
+
+    void writeVarint(std::vector<unsigned char>& out, uint64_t value)
+    {
+        while(value >= 0x80)
+        {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    bool readVarint(const std::vector<unsigned char>& in, size_t& offset, uint64_t& value)
+    {
+        value = 0;
+        for(int shift = 0; offset < in.size() && shift < 64; shift += 7)
+        {
+            unsigned char b = in[offset++];
+            value |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if((b & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+void InputLog::begin(uint64_t seed, const std::string& levelPath, uint64_t mapHash, uint64_t spawnHash,
+    uint64_t mapColumns, float columnsPerUnit)
+{
+    _header = Header{};
+    _header.magic = Magic;
+    _header.version = Version;
+    _header.seed = seed;
+    _header.mapHash = mapHash;
+    _header.spawnHash = spawnHash;
+    _header.mapColumns = mapColumns;
+    _header.columnsPerUnit = columnsPerUnit;
+    _levelPath = levelPath;
+    _runs.clear();
+}
+
+void InputLog::record(const GameWorld::Input& input)
+{
+    uint8_t bits = pack(input);
+    if(!_runs.empty() && _runs.back().bits == bits && _runs.back().ticks < UINT32_MAX)
+    {
+        ++_runs.back().ticks;
+    }
+    else
+    {
+        _runs.push_back(Run{1, bits});
+    }
+    ++_header.tickCount;
+}
+
+bool InputLog::save(const std::string& path) const
+{
+    Header header = _header;
+    header.levelPathLength = static_cast<uint32_t>(_levelPath.size());
+    header.runCount = _runs.size();
+
+    std::vector<unsigned char> body;
+    body.reserve(_runs.size() * 2);
+    for(const Run& run : _runs)
+    {
+        writeVarint(body, run.ticks);
+        body.push_back(run.bits);
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if(file == nullptr)
+    {
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+        && std::fwrite(_levelPath.data(), 1, _levelPath.size(), file) == _levelPath.size()
+        && std::fwrite(body.data(), 1, body.size(), file) == body.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+bool InputLog::load(const std::string& path)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if(file == nullptr)
+    {
+        return false;
+    }
+    Header header{};
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1
+        && header.magic == Magic && header.version == Version;
+    _header = header;
+    std::string levelPath(ok ? header.levelPathLength : 0, '\0');
+    ok = ok && std::fread(levelPath.data(), 1, levelPath.size(), file) == levelPath.size();
+    std::vector<unsigned char> body;
+    unsigned char buffer[4096];
+    for(size_t n; ok && (n = std::fread(buffer, 1, sizeof(buffer), file)) > 0;)
+    {
+        body.insert(body.end(), buffer, buffer + n);
+    }
+    std::fclose(file);
+    if(!ok)
+    {
+        return false;
+    }
+
+    std::vector<Run> runs;
+    runs.reserve(header.runCount);
+    uint64_t ticks{0};
+    size_t offset{0};
+    for(uint64_t i = 0; i < header.runCount; ++i)
+    {
+        uint64_t count;
+        if(!readVarint(body, offset, count) || offset >= body.size() || count == 0 || count > UINT32_MAX)
+        {
+            return false;
+        }
+        runs.push_back(Run{static_cast<uint32_t>(count), body[offset++]});
+        ticks += count;
+    }
+    if(ticks != header.tickCount)
+    {
+        return false;
+    }
+
+    _header = header;
+    _levelPath = std::move(levelPath);
+    _runs = std::move(runs);
+    return true;
+}
+
+uint64_t InputLog::replay(GameWorld& world) const
+{
+    world.setSeed(_header.seed);
+    for(const Run& run : _runs)
+    {
+        GameWorld::Input input = unpack(run.bits);
+        for(uint32_t i = 0; i < run.ticks; ++i)
+        {
+            world.step(GameWorld::FixedTimestep, input);
+        }
+    }
+    return world.stateHash();
+}
+
+uint8_t InputLog::pack(const GameWorld::Input& input)
+{
+    return (input.left ? LEFT : 0) | (input.right ? RIGHT : 0) | (input.jump ? JUMP : 0)
+        | (input.crawl ? CRAWL : 0) | (input.fire ? FIRE : 0) | (input.shake ? SHAKE : 0);
+}
+
+GameWorld::Input InputLog::unpack(uint8_t bits)
+{
+    GameWorld::Input input;
+    input.left = (bits & LEFT) != 0;
+    input.right = (bits & RIGHT) != 0;
+    input.jump = (bits & JUMP) != 0;
+    input.crawl = (bits & CRAWL) != 0;
+    input.fire = (bits & FIRE) != 0;
+    input.shake = (bits & SHAKE) != 0;
+    return input;
+}
+
+uint64_t InputLog::hashMap(const unsigned char* bytes, uint64_t size)
+{
+    uint64_t hash{0xCBF29CE484222325ull};
+    for(uint64_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+uint64_t InputLog::hashSpawns(const SpawnTable* spawns)
+{
+    if(spawns == nullptr)
+    {
+        return hashMap(nullptr, 0);
+    }
+    return hashMap(reinterpret_cast<const unsigned char*>(spawns->entries()),
+        spawns->size() * sizeof(SpawnTable::Entry));
+}
@@ -0,0 +1,62 @@
+#include "inputqueue.h"
+
+void InputQueue::push(Button button, bool down, uint64_t time)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    _events.push_back(Event{time, button, down});
+}
+
+GameWorld::Input InputQueue::take(uint64_t until)
+{
+    _taken.clear();
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        size_t taken{0};
+        for(; taken < _events.size() && _events[taken].time <= until; ++taken)
+        {
+            _taken.push_back(_events[taken]);
+        }
+        // Shift what is left down rather than freeing, so the storage is reused.
+        _events.erase(_events.begin(), _events.begin() + taken);
+    }
+
+    GameWorld::Input pressed;
+    for(const Event& event : _taken)
+    {
+        field(_held, event.button) = event.down;
+        if(event.down)
+        {
+            field(pressed, event.button) = true;
+        }
+        _lastApplied = event.time;
+    }
+
+    GameWorld::Input input = _held;
+    input.left = input.left || pressed.left;
+    input.right = input.right || pressed.right;
+    input.jump = input.jump || pressed.jump;
+    input.crawl = input.crawl || pressed.crawl;
+    input.fire = pressed.fire;
+    input.shake = pressed.shake;
+    return input;
+}
+
+bool& InputQueue::field(GameWorld::Input& input, Button button)
+{
+    switch(button)
+    {
+    case Button::LEFT:
+        return input.left;
+    case Button::RIGHT:
+        return input.right;
+    case Button::JUMP:
+        return input.jump;
+    case Button::CRAWL:
+        return input.crawl;
+    case Button::FIRE:
+        return input.fire;
+    case Button::SHAKE:
+    default:
+        return input.shake;
+    }
+}
@@ -0,0 +1,217 @@
+#include "levelfile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    uint64_t alignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    /* Chunks start on page boundaries, so their byte size must be whole pages. */
+    uint32_t alignColumnsPerChunk(uint32_t columnsPerChunk)
+    {
+        const uint32_t columnsPerPage = LevelFile::PageSize / LevelFile::BytesPerColumn;
+        return static_cast<uint32_t>(alignUp(std::max(columnsPerChunk, 1u), columnsPerPage));
+    }
+}
+
+LevelFile::Writer::Writer(const std::string& path, uint64_t columnCount, float columnsPerUnit, uint32_t columnsPerChunk)
+{
+    _header.magic = Magic;
+    _header.version = Version;
+    _header.bytesPerColumn = BytesPerColumn;
+    _header.columnsPerChunk = alignColumnsPerChunk(columnsPerChunk);
+    _header.columnCount = columnCount;
+    _header.chunkCount = (columnCount + _header.columnsPerChunk - 1) / _header.columnsPerChunk;
+    _header.indexOffset = sizeof(Header);
+    _header.columnsPerUnit = columnsPerUnit;
+    _index.resize(_header.chunkCount);
+    _dataOffset = alignUp(_header.indexOffset + _header.chunkCount * sizeof(ChunkEntry), PageSize);
+
+    _file = std::fopen(path.c_str(), "wb");
+    if(_file == nullptr)
+    {
+        return;
+    }
+    // Reserve the header and index; finish() fills them in.
+    std::vector<unsigned char> zeros(PageSize, 0);
+    for(uint64_t written = 0; written < _dataOffset && _ok; written += PageSize)
+    {
+        _ok = std::fwrite(zeros.data(), 1, PageSize, _file) == PageSize;
+    }
+}
+
+LevelFile::Writer::~Writer() noexcept
+{
+    if(_file != nullptr)
+    {
+        std::fclose(_file);
+    }
+}
+
+uint64_t LevelFile::Writer::chunkColumns(uint64_t chunk) const
+{
+    return std::min<uint64_t>(_header.columnsPerChunk, _header.columnCount - chunkFirst(chunk));
+}
+
+void LevelFile::Writer::writeChunk(uint64_t chunk, const unsigned char* columns)
+{
+    if(!ok())
+    {
+        return;
+    }
+    size_t size = static_cast<size_t>(chunkColumns(chunk) * BytesPerColumn);
+    _index[chunk].offset = _dataOffset;
+    _index[chunk].size = static_cast<uint32_t>(size);
+    _index[chunk].flags = 0;
+    _ok = std::fwrite(columns, 1, size, _file) == size;
+    _dataOffset += size;
+}
+
+bool LevelFile::Writer::finish()
+{
+    if(!ok())
+    {
+        return false;
+    }
+    _ok = std::fseek(_file, 0, SEEK_SET) == 0
+        && std::fwrite(&_header, sizeof(Header), 1, _file) == 1
+        && std::fwrite(_index.data(), sizeof(ChunkEntry), _index.size(), _file) == _index.size();
+    _ok = std::fclose(_file) == 0 && _ok;
+    _file = nullptr;
+    return _ok;
+}
+
+bool LevelFile::write(const std::string& path, const unsigned char* columns, uint64_t columnCount, float columnsPerUnit,
+    uint32_t columnsPerChunk)
+{
+    return write(path, columnCount, columnsPerUnit, [columns](uint64_t first, uint64_t count, unsigned char* out) {
+        std::memcpy(out, columns + first * BytesPerColumn, static_cast<size_t>(count * BytesPerColumn));
+    }, columnsPerChunk);
+}
+
+LevelFile::~LevelFile() noexcept
+{
+    close();
+}
+
+bool LevelFile::open(const std::string& path)
+{
+    close();
+    if(!_file.open(path) || _file.size() < sizeof(Header))
+    {
+        close();
+        return false;
+    }
+    // Fault in only what page() asks for, not the kernel's read-ahead.
+    _file.advise(0, _file.size(), MappedFile::Advice::RANDOM);
+    const unsigned char* data = _file.data();
+    uint64_t size = _file.size();
+
+    std::memcpy(&_header, data, sizeof(Header));
+    uint64_t columnsPerChunk = _header.columnsPerChunk;
+    // Counts and offsets come from the file, so each bound is checked
+    // without sums that could wrap.
+    bool valid = _header.magic == Magic && _header.version == Version
+        && _header.bytesPerColumn == BytesPerColumn && columnsPerChunk > 0
+        && std::isfinite(_header.columnsPerUnit) && _header.columnsPerUnit > 0.0f
+        && _header.chunkCount == _header.columnCount / columnsPerChunk + (_header.columnCount % columnsPerChunk != 0)
+        && _header.indexOffset <= size && _header.indexOffset % alignof(ChunkEntry) == 0
+        && _header.chunkCount <= (size - _header.indexOffset) / sizeof(ChunkEntry);
+    const ChunkEntry* index = valid ? reinterpret_cast<const ChunkEntry*>(data + _header.indexOffset) : nullptr;
+    // Raw chunks must follow each other for columns() to be one array.
+    for(uint64_t i = 0; i < _header.chunkCount && valid; ++i)
+    {
+        uint64_t chunkColumns = std::min(columnsPerChunk, _header.columnCount - i * columnsPerChunk);
+        valid = index[i].flags == 0 && index[i].size == chunkColumns * BytesPerColumn
+            && index[i].offset <= size && index[i].size <= size - index[i].offset
+            && (i == 0 || index[i].offset == index[i - 1].offset + index[i - 1].size);
+    }
+    if(!valid)
+    {
+        close();
+        return false;
+    }
+    _index = index;
+    _columns = _header.chunkCount > 0 ? data + _index[0].offset : nullptr;
+    _windowBegin = _windowEnd = 0;
+    return true;
+}
+
+void LevelFile::close()
+{
+    _file.close();
+    _index = nullptr;
+    _columns = nullptr;
+    _header = Header{};
+    _windowBegin = _windowEnd = 0;
+}
+
+size_t LevelFile::page(uint64_t column, uint64_t radius)
+{
+    if(!isOpen() || _header.chunkCount == 0)
+    {
+        return 0;
+    }
+    uint64_t first = column > radius ? column - radius : 0;
+    uint64_t last = std::min(column + radius, _header.columnCount - 1);
+    uint64_t begin = std::min(first / _header.columnsPerChunk, _header.chunkCount - 1);
+    uint64_t end = std::min(last / _header.columnsPerChunk + 1, _header.chunkCount);
+    begin = std::min(begin, end - 1);
+
+    size_t changed{0};
+    // Release what left the window, then prefetch what entered it.
+    auto release = [&](uint64_t b, uint64_t e) {
+        if(b < e)
+        {
+            advise(b, e, false);
+            changed += e - b;
+        }
+    };
+    auto acquire = [&](uint64_t b, uint64_t e) {
+        if(b < e)
+        {
+            advise(b, e, true);
+            changed += e - b;
+        }
+    };
+    if(_windowBegin == _windowEnd)
+    {
+        // First window: drop whatever a full scan at load time brought in.
+        if(begin > 0)
+        {
+            advise(0, begin, false);
+        }
+        if(end < _header.chunkCount)
+        {
+            advise(end, _header.chunkCount, false);
+        }
+        acquire(begin, end);
+    }
+    else if(end <= _windowBegin || begin >= _windowEnd)
+    {
+        release(_windowBegin, _windowEnd);
+        acquire(begin, end);
+    }
+    else
+    {
+        release(_windowBegin, std::min(begin, _windowEnd));
+        release(std::max(end, _windowBegin), _windowEnd);
+        acquire(begin, std::min(end, _windowBegin));
+        acquire(std::max(begin, _windowEnd), end);
+    }
+    _windowBegin = begin;
+    _windowEnd = end;
+    return changed;
+}
+
+void LevelFile::advise(uint64_t chunkBegin, uint64_t chunkEnd, bool willNeed)
+{
+    uint64_t begin = _index[chunkBegin].offset;
+    uint64_t end = _index[chunkEnd - 1].offset + _index[chunkEnd - 1].size;
+    _file.advise(begin, end - begin, willNeed ? MappedFile::Advice::WILL_NEED : MappedFile::Advice::DONT_NEED);
+}
@@ -0,0 +1,28 @@
+#include "levelimage.h"
+
+// Core decodes with its own copy, kept static so it does not clash with
+// lithium's in the game.
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "gameworld.h"
+#include "mapsaver.h"
+
+bool LevelImage::load(const std::string& path)
+{
+    int width{0};
+    int height{0};
+    int channels{0};
+    unsigned char* image = stbi_load(path.c_str(), &width, &height, &channels, GameWorld::MapStride);
+    if(image == nullptr)
+    {
+        return false;
+    }
+    _path = path;
+    _pixels.assign(image, image + static_cast<size_t>(width) * height * GameWorld::MapStride);
+    stbi_image_free(image);
+    _width = width;
+    _height = height;
+    _unsavedEdits = MapSaver::replayJournal(path, _pixels.data(), width, GameWorld::MapStride);
+    return true;
+}
@@ -0,0 +1,108 @@
+#include "mapeditor.h"
+
+#include <algorithm>
+
+void MapEditor::setMap(unsigned char* bytes, size_t columns, int stride)
+{
+    _bytes = bytes;
+    _columns = columns;
+    _stride = stride;
+    _journal.clear();
+    _cursor = 0;
+    _dirty.clear();
+}
+
+bool MapEditor::set(size_t column, int channel, unsigned char value)
+{
+    if(_bytes == nullptr || column >= _columns || channel < 0 || channel >= _stride)
+    {
+        return false;
+    }
+    unsigned char before = get(column, channel);
+    if(before == value)
+    {
+        return false;
+    }
+
+    // A new edit drops whatever could have been redone.
+    _journal.erase(_journal.begin() + _cursor, _journal.end());
+    _journal.push_back(Edit{static_cast<uint32_t>(column), static_cast<uint8_t>(channel), before, value});
+    if(_journal.size() > MaxJournal)
+    {
+        _journal.pop_front();
+    }
+    _cursor = _journal.size();
+
+    apply(_journal.back(), true);
+    return true;
+}
+
+bool MapEditor::undo()
+{
+    if(!canUndo())
+    {
+        return false;
+    }
+    apply(_journal[--_cursor], false);
+    return true;
+}
+
+bool MapEditor::redo()
+{
+    if(!canRedo())
+    {
+        return false;
+    }
+    apply(_journal[_cursor++], true);
+    return true;
+}
+
+void MapEditor::apply(const Edit& edit, bool forward)
+{
+    _bytes[edit.column * _stride + edit.channel] = forward ? edit.after : edit.before;
+    markDirty(edit.column);
+    ++_stats.edits;
+}
+
+void MapEditor::markDirty(size_t column)
+{
+    if(!_dirty.empty())
+    {
+        Span& last = _dirty.back();
+        if(column + 1 >= last.first && column <= last.first + last.count)
+        {
+            size_t first = std::min(last.first, column);
+            last.count = std::max(last.first + last.count, column + 1) - first;
+            last.first = first;
+            return;
+        }
+    }
+    _dirty.push_back(Span{column, 1});
+}
+
+void MapEditor::coalesce()
+{
+    if(_dirty.size() < 2)
+    {
+        return;
+    }
+    std::sort(_dirty.begin(), _dirty.end(), [](const Span& a, const Span& b) {
+        return a.first < b.first;
+    });
+    size_t out{0};
+    for(size_t i = 1; i < _dirty.size(); ++i)
+    {
+        Span& merged = _dirty[out];
+        const Span& span = _dirty[i];
+        size_t end = merged.first + merged.count;
+        if(span.first <= end + MergeGap)
+        {
+            merged.count = std::max(end, span.first + span.count) - merged.first;
+        }
+        else
+        {
+            _dirty[++out] = span;
+        }
+    }
+    _dirty.resize(out + 1);
+}
@@ -0,0 +1,117 @@
+#include "mappedfile.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const uint64_t PageSize{4096};
+}
+
+MappedFile::~MappedFile() noexcept
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+#ifdef _WIN32
+    _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(_file == INVALID_HANDLE_VALUE)
+    {
+        _file = nullptr;
+        return false;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(_file, &size);
+    _size = static_cast<uint64_t>(size.QuadPart);
+    _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(_mapping != nullptr)
+    {
+        _data = static_cast<unsigned char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    _fd = ::open(path.c_str(), O_RDONLY);
+    if(_fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    if(fstat(_fd, &st) == 0 && st.st_size > 0)
+    {
+        _size = static_cast<uint64_t>(st.st_size);
+        void* data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, _fd, 0);
+        if(data != MAP_FAILED)
+        {
+            _data = static_cast<unsigned char*>(data);
+        }
+    }
+#endif
+    if(_data == nullptr)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if(_data != nullptr)
+    {
+        UnmapViewOfFile(_data);
+    }
+    if(_mapping != nullptr)
+    {
+        CloseHandle(_mapping);
+        _mapping = nullptr;
+    }
+    if(_file != nullptr)
+    {
+        CloseHandle(_file);
+        _file = nullptr;
+    }
+#else
+    if(_data != nullptr)
+    {
+        munmap(_data, _size);
+    }
+    if(_fd >= 0)
+    {
+        ::close(_fd);
+        _fd = -1;
+    }
+#endif
+    _data = nullptr;
+    _size = 0;
+}
+
+void MappedFile::advise(uint64_t offset, uint64_t length, Advice advice)
+{
+#ifdef _WIN32
+    // Windows pages mapped views in on demand and trims them under pressure.
+    (void)offset;
+    (void)length;
+    (void)advice;
+#else
+    if(_data == nullptr || offset >= _size)
+    {
+        return;
+    }
+    uint64_t begin = offset / PageSize * PageSize;
+    uint64_t end = std::min((offset + length + PageSize - 1) / PageSize * PageSize,
+        (_size + PageSize - 1) / PageSize * PageSize);
+    int flag = advice == Advice::RANDOM ? MADV_RANDOM : advice == Advice::WILL_NEED ? MADV_WILLNEED : MADV_DONTNEED;
+    madvise(_data + begin, end - begin, flag);
+#endif
+}
@@ -0,0 +1,296 @@
+#include "mapsaver.h"
+
+#include <chrono>
+#include <cstring>
+// Static like the decoder in levelimage.cpp.
+#define STBIW_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    void appendToFile(void* context, void* data, int size)
+    {
+        std::fwrite(data, 1, static_cast<size_t>(size), static_cast<std::FILE*>(context));
+    }
+
+    /* Flushes file all the way to the disk, so a rename never exposes a partial image. */
+    bool sync(std::FILE* file)
+    {
+        if(std::fflush(file) != 0)
+        {
+            return false;
+        }
+#ifdef _WIN32
+        return _commit(_fileno(file)) == 0;
+#else
+        return fsync(fileno(file)) == 0;
+#endif
+    }
+
+    bool replace(const std::string& from, const std::string& to)
+    {
+#ifdef _WIN32
+        return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+    }
+}
+
+MapSaver::MapSaver()
+{
+    _thread = std::thread{&MapSaver::run, this};
+}
+
+MapSaver::~MapSaver() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _stopping = true;
+    }
+    _wake.notify_all();
+    _thread.join();
+    if(_journal != nullptr)
+    {
+        std::fclose(_journal);
+    }
+}
+
+void MapSaver::setMap(const unsigned char* bytes, int width, int height, int channels, const std::string& path)
+{
+    wait();
+    _bytes = bytes;
+    _width = width;
+    _height = height;
+    _channels = channels;
+    _path = path;
+
+    _image.assign(bytes, bytes + static_cast<size_t>(width) * height * channels);
+
+    // Keep appending to a journal that still applies to this map; replayJournal() has folded it in.
+    if(_journal != nullptr)
+    {
+        std::fclose(_journal);
+        _journal = nullptr;
+    }
+    std::string journal = journalPath(path);
+    if(std::FILE* file = std::fopen(journal.c_str(), "rb"))
+    {
+        JournalHeader header{};
+        bool matches = std::fread(&header, sizeof(header), 1, file) == 1 && header.magic == JournalMagic
+            && header.version == JournalVersion && header.width == static_cast<uint32_t>(width)
+            && header.channels == static_cast<uint32_t>(channels);
+        std::fclose(file);
+        if(matches)
+        {
+            _journal = std::fopen(journal.c_str(), "ab");
+        }
+    }
+    if(_journal == nullptr)
+    {
+        resetJournal();
+    }
+}
+
+void MapSaver::changed(const MapEditor::Span& span)
+{
+    if(_bytes == nullptr || span.count == 0 || span.first + span.count > static_cast<size_t>(_width))
+    {
+        return;
+    }
+    Job job;
+    job.first = static_cast<uint32_t>(span.first);
+    job.count = static_cast<uint32_t>(span.count);
+    job.bytes.assign(_bytes + span.first * _channels, _bytes + (span.first + span.count) * _channels);
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _jobs.push_back(std::move(job));
+    }
+    _wake.notify_one();
+}
+
+void MapSaver::save()
+{
+    if(_bytes == nullptr)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        if(!_jobs.empty() && _jobs.back().save)
+        {
+            return;
+        }
+        Job job;
+        job.save = true;
+        _jobs.push_back(std::move(job));
+    }
+    _wake.notify_one();
+}
+
+void MapSaver::wait()
+{
+    std::unique_lock<std::mutex> lock{_mutex};
+    _idle.wait(lock, [this]() { return _jobs.empty() && !_writing; });
+}
+
+bool MapSaver::busy() const
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    return !_jobs.empty() || _writing;
+}
+
+MapSaver::Stats MapSaver::stats() const
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    return _stats;
+}
+
+void MapSaver::run()
+{
+    std::unique_lock<std::mutex> lock{_mutex};
+    while(true)
+    {
+        _wake.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+        if(_jobs.empty())
+        {
+            // Only stopping gets here; queued work is always finished first.
+            return;
+        }
+        std::swap(_jobs, _batch);
+        _writing = true;
+        lock.unlock();
+
+        // In queue order, so records queued after a save land in the journal it emptied.
+        size_t records{0};
+        size_t saves{0};
+        size_t failures{0};
+        double writeSeconds{-1.0};
+        for(const Job& job : _batch)
+        {
+            if(!job.save)
+            {
+                std::memcpy(_image.data() + static_cast<size_t>(job.first) * _channels, job.bytes.data(), job.bytes.size());
+                appendJournal(job);
+                ++records;
+                continue;
+            }
+            auto start = std::chrono::steady_clock::now();
+            if(write())
+            {
+                ++saves;
+                resetJournal();
+            }
+            else
+            {
+                ++failures;
+            }
+            writeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        if(_journal != nullptr)
+        {
+            std::fflush(_journal);
+        }
+        _batch.clear();
+
+        lock.lock();
+        _stats.journalRecords += records;
+        _stats.saves += saves;
+        _stats.failures += failures;
+        if(writeSeconds >= 0.0)
+        {
+            _stats.lastWriteSeconds = writeSeconds;
+        }
+        _writing = false;
+        if(_jobs.empty())
+        {
+            _idle.notify_all();
+        }
+    }
+}
+
+void MapSaver::appendJournal(const Job& job)
+{
+    if(_journal == nullptr)
+    {
+        return;
+    }
+    std::fwrite(&job.first, sizeof(job.first), 1, _journal);
+    std::fwrite(&job.count, sizeof(job.count), 1, _journal);
+    std::fwrite(job.bytes.data(), 1, job.bytes.size(), _journal);
+}
+
+bool MapSaver::write()
+{
+    std::string temporary = _path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if(file == nullptr)
+    {
+        return false;
+    }
+    bool ok = stbi_write_png_to_func(appendToFile, file, _width, _height, _channels, _image.data(),
+        _width * _channels) != 0;
+    ok = !std::ferror(file) && sync(file) && ok;
+    ok = std::fclose(file) == 0 && ok;
+    if(!ok || !replace(temporary, _path))
+    {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool MapSaver::resetJournal()
+{
+    if(_journal != nullptr)
+    {
+        std::fclose(_journal);
+    }
+    _journal = std::fopen(journalPath(_path).c_str(), "wb");
+    if(_journal == nullptr)
+    {
+        return false;
+    }
+    JournalHeader header{JournalMagic, JournalVersion, static_cast<uint32_t>(_width), static_cast<uint32_t>(_channels)};
+    return std::fwrite(&header, sizeof(header), 1, _journal) == 1 && std::fflush(_journal) == 0;
+}
+
+size_t MapSaver::replayJournal(const std::string& path, unsigned char* bytes, int width, int channels)
+{
+    std::FILE* file = std::fopen(journalPath(path).c_str(), "rb");
+    if(file == nullptr)
+    {
+        return 0;
+    }
+    JournalHeader header{};
+    size_t applied{0};
+    if(std::fread(&header, sizeof(header), 1, file) == 1 && header.magic == JournalMagic
+        && header.version == JournalVersion && header.width == static_cast<uint32_t>(width)
+        && header.channels == static_cast<uint32_t>(channels))
+    {
+        uint32_t first{0};
+        uint32_t count{0};
+        std::vector<unsigned char> record;
+        while(std::fread(&first, sizeof(first), 1, file) == 1 && std::fread(&count, sizeof(count), 1, file) == 1
+            && static_cast<uint64_t>(first) + count <= static_cast<uint64_t>(width))
+        {
+            record.resize(static_cast<size_t>(count) * channels);
+            if(std::fread(record.data(), 1, record.size(), file) != record.size())
+            {
+                break;
+            }
+            std::memcpy(bytes + static_cast<size_t>(first) * channels, record.data(), record.size());
+            ++applied;
+        }
+    }
+    std::fclose(file);
+    return applied;
+}
@@ -0,0 +1,115 @@
+#include "particlesystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    struct Style
+    {
+        size_t count;
+        float speed;
+        /* Added to every particle's vertical velocity, so bursts fountain up. */
+        float lift;
+        float gravity;
+        float lifetime;
+    };
+
+    const Style Styles[ParticleSystem::KindCount] = {
+        /* COLLECT */ {12, 0.25f, 0.15f, -0.6f, 0.5f},
+        /* DEATH */   {16, 0.35f, 0.20f, -2.0f, 0.6f},
+        /* IMPACT */  {8, 0.50f, 0.10f, -2.0f, 0.25f},
+        /* SPLASH */  {20, 0.30f, 0.60f, -3.0f, 0.7f},
+    };
+}
+
+ParticleSystem::ParticleSystem(size_t capacity) :
+    _blocks((capacity + Lanes - 1) / Lanes), _invLifetime(capacity), _kind(capacity)
+{
+    _expiring.reserve(_blocks.size());
+}
+
+size_t ParticleSystem::burst(Kind kind, const glm::vec2& position)
+{
+    return burst(kind, position, Styles[kind].count);
+}
+
+size_t ParticleSystem::burst(Kind kind, const glm::vec2& position, size_t count)
+{
+    const Style& style = Styles[kind];
+    count = std::min(count, capacity() - _count);
+    for(size_t i = _count; i < _count + count; ++i)
+    {
+        // Evenly spread directions, each at half to full speed.
+        float angle = _random.below(65536) * (6.2831853f / 65536.0f);
+        float speed = style.speed * (0.5f + _random.below(65536) * (0.5f / 65536.0f));
+        Block& block = _blocks[i / Lanes];
+        const size_t l = i % Lanes;
+        block.x[l] = position.x;
+        block.y[l] = position.y;
+        block.vx[l] = std::cos(angle) * speed;
+        block.vy[l] = std::sin(angle) * speed + style.lift;
+        block.gravity[l] = style.gravity;
+        // Staggered a little so a burst thins out instead of vanishing at once.
+        block.life[l] = style.lifetime * (0.75f + _random.below(65536) * (0.25f / 65536.0f));
+        _invLifetime[i] = 1.0f / block.life[l];
+        _kind[i] = kind;
+    }
+    _count += count;
+    return count;
+}
+
+void ParticleSystem::update(float dt)
+{
+    // The last block is integrated whole; the slots past the end hold nothing.
+    const size_t blocks = (_count + Lanes - 1) / Lanes;
+    _expiring.clear();
+    for(size_t b = 0; b < blocks; ++b)
+    {
+        Block& block = _blocks[b];
+        int expired = 0;
+        for(int l = 0; l < Lanes; ++l)
+        {
+            block.vy[l] += block.gravity[l] * dt;
+            block.x[l] += block.vx[l] * dt;
+            block.y[l] += block.vy[l] * dt;
+            block.life[l] -= dt;
+            expired += block.life[l] <= 0.0f;
+        }
+        if(expired != 0)
+        {
+            _expiring.push_back(b);
+        }
+    }
+
+    // Only a few percent expire in a step, so rather than shifting every
+    // particle along, expired ones are replaced by the last particle. Going
+    // from the back, everything after the block at hand is already live.
+    // Particles are not drawn in any particular order.
+    for(auto b = _expiring.rbegin(); b != _expiring.rend(); ++b)
+    {
+        for(size_t i = std::min((*b + 1) * Lanes, _count); i-- > *b * Lanes;)
+        {
+            if(_blocks[*b].life[i % Lanes] <= 0.0f)
+            {
+                move(--_count, i);
+            }
+        }
+    }
+}
+
+void ParticleSystem::move(size_t from, size_t to)
+{
+    const Block& source = _blocks[from / Lanes];
+    Block& target = _blocks[to / Lanes];
+    const size_t f = from % Lanes;
+    const size_t t = to % Lanes;
+    target.x[t] = source.x[f];
+    target.y[t] = source.y[f];
+    target.vx[t] = source.vx[f];
+    target.vy[t] = source.vy[f];
+    target.gravity[t] = source.gravity[f];
+    target.life[t] = source.life[f];
+    _invLifetime[to] = _invLifetime[from];
+    _kind[to] = _kind[from];
+}
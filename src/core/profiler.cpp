@@ -0,0 +1,146 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+namespace
+{
+    // Rings are never freed, so a snapshot can read a thread's ring after the
+    // thread has exited.
+    std::mutex registryMutex;
+    std::vector<void*> registry;
+    uint64_t epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    double percentile(std::vector<double>& sorted, double p)
+    {
+        size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+}
+
+uint64_t Profiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count() - epoch;
+}
+
+Profiler::Ring& Profiler::ring()
+{
+    thread_local Ring* local = [] {
+        Ring* ring = new Ring();
+        std::lock_guard<std::mutex> lock{registryMutex};
+        ring->thread = static_cast<uint32_t>(registry.size());
+        registry.push_back(ring);
+        return ring;
+    }();
+    return *local;
+}
+
+void Profiler::record(const char* name, uint64_t begin, uint64_t end)
+{
+    Ring& r = ring();
+    uint64_t head = r.head.load(std::memory_order_relaxed);
+    r.samples[head % RingSize] = Sample{name, begin, end};
+    r.head.store(head + 1, std::memory_order_release);
+}
+
+std::vector<std::pair<uint32_t, std::vector<Profiler::Sample>>> Profiler::snapshot()
+{
+    std::vector<Ring*> rings;
+    {
+        std::lock_guard<std::mutex> lock{registryMutex};
+        for(void* ring : registry)
+        {
+            rings.push_back(static_cast<Ring*>(ring));
+        }
+    }
+
+    std::vector<std::pair<uint32_t, std::vector<Sample>>> result;
+    for(Ring* ring : rings)
+    {
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t first = head > RingSize ? head - RingSize : 0;
+        std::vector<Sample> samples;
+        samples.reserve(head - first);
+        for(uint64_t i = first; i < head; ++i)
+        {
+            samples.push_back(ring->samples[i % RingSize]);
+        }
+        // The owner kept writing while we copied; drop what it may have overwritten.
+        uint64_t after = ring->head.load(std::memory_order_acquire);
+        size_t torn = static_cast<size_t>(std::min<uint64_t>(after > RingSize + first ? after - RingSize - first : 0,
+            samples.size()));
+        samples.erase(samples.begin(), samples.begin() + torn);
+        result.emplace_back(ring->thread, std::move(samples));
+    }
+    return result;
+}
+
+std::vector<Profiler::ZoneStats> Profiler::summary()
+{
+    std::map<std::string, std::vector<double>> durations;
+    for(auto& thread : snapshot())
+    {
+        for(const Sample& sample : thread.second)
+        {
+            durations[sample.name].push_back((sample.end - sample.begin) * 1e-3);
+        }
+    }
+
+    std::vector<ZoneStats> stats;
+    for(auto& zone : durations)
+    {
+        std::vector<double>& d = zone.second;
+        std::sort(d.begin(), d.end());
+        double total{0.0};
+        for(double value : d)
+        {
+            total += value;
+        }
+        stats.push_back(ZoneStats{zone.first, d.size(), percentile(d, 0.5), percentile(d, 0.99), total});
+    }
+    return stats;
+}
+
+void Profiler::printSummary(std::FILE* out)
+{
+    std::fprintf(out, "%-24s %8s %10s %10s\n", "zone", "count", "p50 us", "p99 us");
+    for(const ZoneStats& zone : summary())
+    {
+        std::fprintf(out, "%-24s %8zu %10.2f %10.2f\n", zone.name.c_str(), zone.count, zone.p50, zone.p99);
+    }
+}
+
+bool Profiler::writeChromeTrace(const std::string& path)
+{
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if(file == nullptr)
+    {
+        return false;
+    }
+    std::fprintf(file, "{\"traceEvents\":[");
+    bool first{true};
+    for(auto& thread : snapshot())
+    {
+        for(const Sample& sample : thread.second)
+        {
+            std::fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                first ? "" : ",", sample.name, thread.first, sample.begin * 1e-3, (sample.end - sample.begin) * 1e-3);
+            first = false;
+        }
+    }
+    std::fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    return std::fclose(file) == 0;
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock{registryMutex};
+    for(void* ring : registry)
+    {
+        static_cast<Ring*>(ring)->head.store(0, std::memory_order_release);
+    }
+}
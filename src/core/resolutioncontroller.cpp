@@ -0,0 +1,61 @@
+#include "resolutioncontroller.h"
+
+#include <algorithm>
+#include <cmath>
+
+ResolutionController::ResolutionController() : ResolutionController{Config{}}
+{
+}
+
+ResolutionController::ResolutionController(const Config& config) : _config{config}, _scale{config.maxScale}
+{
+}
+
+float ResolutionController::update(float frameMs)
+{
+    if(!(frameMs > 0.0f))
+    {
+        return _scale;
+    }
+    _smoothedMs = _primed ? glm::mix(_smoothedMs, frameMs, _config.smoothing) : frameMs;
+    _primed = true;
+
+    if(++_framesSinceChange < _config.settleFrames)
+    {
+        return _scale;
+    }
+
+    const float high = _config.budgetMs * (1.0f + _config.hysteresis);
+    const float low = _config.budgetMs * (1.0f - _config.hysteresis);
+    if(_smoothedMs <= high && _smoothedMs >= low)
+    {
+        return _scale;
+    }
+
+    float target = _scale * std::sqrt(_config.budgetMs / _smoothedMs);
+    target = std::clamp(target, _scale - _config.maxStepDown, _scale + _config.maxStepUp);
+    target = std::clamp(target, _config.minScale, _config.maxScale);
+    if(std::abs(target - _scale) < 0.005f)
+    {
+        return _scale;
+    }
+
+    _scale = target;
+    // Samples from the old scale would drag the average; start over.
+    _primed = false;
+    _framesSinceChange = 0;
+    ++_changes;
+    return _scale;
+}
+
+glm::ivec2 ResolutionController::resolution(const glm::ivec2& native) const
+{
+    const int g = std::max(_config.granularity, 1);
+    glm::ivec2 size;
+    for(int i = 0; i < 2; ++i)
+    {
+        int pixels = static_cast<int>(std::lround(native[i] * _scale / g)) * g;
+        size[i] = std::clamp(pixels, std::min(g, native[i]), native[i]);
+    }
+    return size;
+}
@@ -0,0 +1,335 @@
+#include "rewindbuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include "profiler.h"
+
+namespace
+{
+    // Zero runs shorter than this stay inside a literal run; a run header
+    // costs two bytes.
+    const size_t MinZeroRun{4};
+
+    void writeVarint(std::vector<unsigned char>& out, uint64_t value)
+    {
+        while(value >= 0x80)
+        {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    bool readVarint(const unsigned char* in, size_t size, size_t& offset, uint64_t& value)
+    {
+        value = 0;
+        for(int shift = 0; offset < size && shift < 64; shift += 7)
+        {
+            unsigned char b = in[offset++];
+            value |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if((b & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    unsigned char xorAt(const std::vector<unsigned char>& state, const std::vector<unsigned char>& base, size_t i)
+    {
+        return (i < state.size() ? state[i] : 0) ^ (i < base.size() ? base[i] : 0);
+    }
+
+    /* First index from i on where state and base differ, a word at a time. */
+    size_t skipEqual(const std::vector<unsigned char>& state, const std::vector<unsigned char>& base, size_t i,
+        size_t length)
+    {
+        size_t shared = std::min(state.size(), base.size());
+        while(i + sizeof(uint64_t) <= shared)
+        {
+            uint64_t a;
+            uint64_t b;
+            std::memcpy(&a, state.data() + i, sizeof(a));
+            std::memcpy(&b, base.data() + i, sizeof(b));
+            if(a != b)
+            {
+                break;
+            }
+            i += sizeof(uint64_t);
+        }
+        while(i < length && xorAt(state, base, i) == 0)
+        {
+            ++i;
+        }
+        return i;
+    }
+
+    /* XORs the runs from offset on into state, which must be long enough for them. */
+    bool applyRuns(const unsigned char* in, size_t inSize, size_t offset, std::vector<unsigned char>& state)
+    {
+        size_t size = state.size();
+        size_t i{0};
+        while(offset < inSize)
+        {
+            uint64_t zeros;
+            uint64_t literal;
+            if(!readVarint(in, inSize, offset, zeros) || !readVarint(in, inSize, offset, literal)
+                || zeros > size - i || literal > size - i - zeros || literal > inSize - offset)
+            {
+                return false;
+            }
+            i += zeros;
+            for(uint64_t j = 0; j < literal; ++j)
+            {
+                state[i++] ^= in[offset++];
+            }
+        }
+        return true;
+    }
+}
+
+RewindBuffer::RewindBuffer() : RewindBuffer{Config{}}
+{
+}
+
+RewindBuffer::RewindBuffer(const Config& config) : _config{config}
+{
+}
+
+void RewindBuffer::encode(const std::vector<unsigned char>& state, const std::vector<unsigned char>& base,
+    std::vector<unsigned char>& out)
+{
+    out.clear();
+    writeVarint(out, state.size());
+    // Past the end of a shorter state the runs carry the base's tail, so a
+    // delta can be undone as well as applied.
+    size_t length = std::max(state.size(), base.size());
+    size_t i{0};
+    while(i < length)
+    {
+        size_t literal = skipEqual(state, base, i, length);
+        size_t zeros = literal - i;
+
+        // Extend the literal run until a zero run worth its header.
+        size_t end = literal;
+        size_t zeroRun{0};
+        while(end < length && zeroRun < MinZeroRun)
+        {
+            zeroRun = xorAt(state, base, end) == 0 ? zeroRun + 1 : 0;
+            ++end;
+        }
+        if(zeroRun >= MinZeroRun)
+        {
+            end -= zeroRun;
+        }
+
+        writeVarint(out, zeros);
+        writeVarint(out, end - literal);
+        for(size_t j = literal; j < end; ++j)
+        {
+            out.push_back(xorAt(state, base, j));
+        }
+        i = end;
+    }
+}
+
+bool RewindBuffer::decode(const unsigned char* in, size_t inSize, std::vector<unsigned char>& state)
+{
+    size_t offset{0};
+    uint64_t size;
+    if(!readVarint(in, inSize, offset, size))
+    {
+        return false;
+    }
+    state.resize(std::max<size_t>(size, state.size()));
+    if(!applyRuns(in, inSize, offset, state))
+    {
+        return false;
+    }
+    state.resize(size);
+    return true;
+}
+
+bool RewindBuffer::undo(const unsigned char* in, size_t inSize, size_t baseSize, std::vector<unsigned char>& state)
+{
+    size_t offset{0};
+    uint64_t size;
+    if(!readVarint(in, inSize, offset, size) || size != state.size())
+    {
+        return false;
+    }
+    state.resize(std::max<size_t>(size, baseSize));
+    if(!applyRuns(in, inSize, offset, state))
+    {
+        return false;
+    }
+    state.resize(baseSize);
+    return true;
+}
+
+void RewindBuffer::push(const GameWorld& world)
+{
+    PROFILE_ZONE("rewind push");
+    if(_arena.empty())
+    {
+        _arena.resize(_config.budgetBytes);
+        _ring.resize(std::max<size_t>(_config.maxFrames, 1));
+    }
+
+    unsigned long long tick = world.ticks();
+    if(_count && tick != newestTick() + 1)
+    {
+        // Back in time after a restore: branch off there. A gap forward
+        // leaves nothing to delta against.
+        truncate(tick > newestTick() ? 0 : tick);
+    }
+
+    _state.clear();
+    world.saveState(_state);
+
+    Frame added;
+    added.tick = tick;
+    if(_count && !_forceKeyframe && frame(_count - 1).keyOffset + 1 < static_cast<uint32_t>(_config.keyframeInterval))
+    {
+        added.keyOffset = frame(_count - 1).keyOffset + 1;
+    }
+    added.baseSize = added.keyOffset ? static_cast<uint32_t>(_previous.size()) : 0;
+    static const std::vector<unsigned char> none;
+    encode(_state, added.keyOffset ? _previous : none, _encoded);
+
+    bool stored = _encoded.size() <= _arena.size() && makeRoom(_encoded.size(), added.offset);
+    if(!stored && added.keyOffset)
+    {
+        // Making room dropped the frames the delta was against.
+        truncate(0);
+        added.keyOffset = 0;
+        added.baseSize = 0;
+        encode(_state, none, _encoded);
+        stored = _encoded.size() <= _arena.size() && makeRoom(_encoded.size(), added.offset);
+    }
+    std::swap(_previous, _state);
+    if(!stored)
+    {
+        // A state bigger than the whole budget: keep nothing.
+        truncate(0);
+        return;
+    }
+
+    std::copy(_encoded.begin(), _encoded.end(), _arena.begin() + added.offset);
+    added.size = static_cast<uint32_t>(_encoded.size());
+    _head = added.offset + added.size;
+    _bytes += added.size;
+    _forceKeyframe = false;
+    frame(_count++) = added;
+}
+
+bool RewindBuffer::restore(unsigned long long tick, GameWorld& world)
+{
+    PROFILE_ZONE("rewind restore");
+    if(_count == 0 || tick < oldestTick() || tick > newestTick())
+    {
+        return false;
+    }
+    size_t index = static_cast<size_t>(tick - oldestTick());
+    size_t key = index - frame(index).keyOffset;
+
+    // Continue from the last restore when it lies between the keyframe and
+    // tick, or undo deltas back from it when it is later in the same group
+    // and nearer than the keyframe; otherwise start over from the keyframe. Stepping either way costs one
+    // delta per tick, except for crossing a keyframe backwards.
+    size_t decoded = static_cast<size_t>(_decodedTick - oldestTick());
+    size_t next;
+    if(_decodedValid && _decodedTick >= frame(key).tick && _decodedTick <= tick)
+    {
+        next = decoded + 1;
+    }
+    else if(_decodedValid && _decodedTick > tick && _decodedTick <= newestTick()
+        && decoded - frame(decoded).keyOffset == key && decoded - index <= index - key)
+    {
+        for(; decoded > index; --decoded)
+        {
+            const Frame& f = frame(decoded);
+            if(!undo(_arena.data() + f.offset, f.size, f.baseSize, _decoded))
+            {
+                _decodedValid = false;
+                return false;
+            }
+        }
+        next = index + 1;
+    }
+    else
+    {
+        _decoded.clear();
+        next = key;
+    }
+    for(; next <= index; ++next)
+    {
+        const Frame& f = frame(next);
+        if(!decode(_arena.data() + f.offset, f.size, _decoded))
+        {
+            _decodedValid = false;
+            return false;
+        }
+    }
+    _decodedTick = tick;
+    _decodedValid = true;
+    return world.loadState(_decoded.data(), _decoded.size());
+}
+
+void RewindBuffer::clear()
+{
+    truncate(0);
+}
+
+bool RewindBuffer::makeRoom(size_t size, size_t& offset)
+{
+    bool hadFrames = _count > 0;
+    if(!hadFrames)
+    {
+        _head = 0;
+    }
+    offset = _head + size <= _arena.size() ? _head : 0;
+    if(offset != _head)
+    {
+        // Wrapping: whatever lies past the head is older than anything below it.
+        while(_count && frame(0).offset >= _head)
+        {
+            dropOldestGroup();
+        }
+    }
+    // Writing forward from the head runs into the oldest frames first.
+    while(_count && frame(0).offset < offset + size && offset < frame(0).offset + frame(0).size)
+    {
+        dropOldestGroup();
+    }
+    while(_count == _ring.size())
+    {
+        dropOldestGroup();
+    }
+    return !hadFrames || _count > 0;
+}
+
+void RewindBuffer::dropOldestGroup()
+{
+    do
+    {
+        _bytes -= frame(0).size;
+        _first = (_first + 1) % _ring.size();
+        --_count;
+    }
+    while(_count && frame(0).keyOffset != 0);
+}
+
+void RewindBuffer::truncate(unsigned long long tick)
+{
+    while(_count && frame(_count - 1).tick >= tick)
+    {
+        _bytes -= frame(_count - 1).size;
+        --_count;
+    }
+    _head = _count ? frame(_count - 1).offset + frame(_count - 1).size : 0;
+    // _previous belongs to the dropped frames, so the next push starts a
+    // keyframe whatever the frame before it was.
+    _forceKeyframe = true;
+    _decodedValid = false;
+}
@@ -0,0 +1,40 @@
+#include "shaderlayout.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+std::string shaderlayout::declareBlock(const char* block, const Field* fields, size_t count)
+{
+    std::string out = std::string("layout(std140) uniform ") + block + "\n{\n";
+    for(size_t i = 0; i < count; ++i)
+    {
+        out += std::string("    ") + fields[i].type + " " + fields[i].name + ";\n";
+    }
+    out += "};\n";
+    return out;
+}
+
+std::string shaderlayout::declareConstant(const char* name, int value)
+{
+    return std::string("const int ") + name + " = " + std::to_string(value) + ";\n";
+}
+
+std::string shaderlayout::declareConstant(const char* name, float value)
+{
+    // Shortest text that reads back as the same float, as a GLSL float literal.
+    char text[32];
+    for(int precision = 6; precision <= 9; ++precision)
+    {
+        snprintf(text, sizeof(text), "%.*g", precision, value);
+        if(strtof(text, nullptr) == value)
+        {
+            break;
+        }
+    }
+    std::string literal = text;
+    if(literal.find_first_of(".e") == std::string::npos)
+    {
+        literal += ".0";
+    }
+    return std::string("const float ") + name + " = " + literal + ";\n";
+}
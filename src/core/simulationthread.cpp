@@ -0,0 +1,143 @@
+#include "simulationthread.h"
+
+#include <algorithm>
+#include <chrono>
+#include "inputlog.h"
+#include "profiler.h"
+
+namespace
+{
+    // Input bits that are consumed by the step that sees them.
+    const uint8_t OneShotBits = InputLog::pack([] {
+        GameWorld::Input input;
+        input.fire = true;
+        input.shake = true;
+        return input;
+    }());
+}
+
+SimulationThread::SimulationThread(GameWorld& world) : _world{world}
+{
+}
+
+SimulationThread::~SimulationThread() noexcept
+{
+    stop();
+}
+
+void SimulationThread::start()
+{
+    if(_running.exchange(true))
+    {
+        return;
+    }
+    _thread = std::thread{&SimulationThread::run, this};
+}
+
+void SimulationThread::stop()
+{
+    _running = false;
+    if(_thread.joinable())
+    {
+        _thread.join();
+    }
+}
+
+void SimulationThread::setInput(const GameWorld::Input& input)
+{
+    uint8_t bits = InputLog::pack(input);
+    _held.store(bits & ~OneShotBits, std::memory_order_relaxed);
+    _oneShots.fetch_or(bits & OneShotBits, std::memory_order_relaxed);
+}
+
+void SimulationThread::post(std::function<void(GameWorld&)> job)
+{
+    std::lock_guard<std::mutex> lock{_jobMutex};
+    _jobs.push_back(std::move(job));
+}
+
+void SimulationThread::run()
+{
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float>(GameWorld::FixedTimestep));
+    auto next = Clock::now();
+    while(_running.load(std::memory_order_relaxed))
+    {
+        {
+            std::lock_guard<std::mutex> lock{_jobMutex};
+            std::swap(_jobs, _runningJobs);
+        }
+        for(auto& job : _runningJobs)
+        {
+            job(_world);
+        }
+        _runningJobs.clear();
+
+        uint8_t bits = _held.load(std::memory_order_relaxed) | _oneShots.exchange(0, std::memory_order_relaxed)
+            | InputLog::pack(_inputQueue.take(Profiler::now()));
+        if(_rewind && _rewinding.load(std::memory_order_relaxed))
+        {
+            if(_world.ticks() > _rewind->oldestTick())
+            {
+                _rewind->restore(_world.ticks() - 1, _world);
+            }
+        }
+        else
+        {
+            _world.step(GameWorld::FixedTimestep, InputLog::unpack(bits));
+            if(_rewind)
+            {
+                _rewind->push(_world);
+            }
+        }
+
+        {
+            PROFILE_ZONE("snapshot");
+            WorldSnapshot& snapshot = _snapshots.back();
+            _world.snapshot(snapshot);
+            snapshot.stamp = Profiler::now();
+            snapshot.inputStamp = _inputQueue.lastApplied();
+            _snapshots.publish();
+        }
+        _steps.fetch_add(1, std::memory_order_relaxed);
+
+        // Like GameWorld::advance, drop time we cannot catch up on.
+        next += period;
+        auto now = Clock::now();
+        if(now - next > period * GameWorld::MaxStepsPerAdvance)
+        {
+            next = now;
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
+
+bool SimulationThread::read(WorldSnapshot& out)
+{
+    while(_snapshots.update())
+    {
+        std::swap(_previous, _current);
+        _current = _snapshots.front();
+        ++_received;
+    }
+    if(_received == 0)
+    {
+        return false;
+    }
+    if(_received == 1)
+    {
+        out = _current;
+        return true;
+    }
+
+    // Display one step behind now, placed between the stamps of the pair. A
+    // slow reader misses snapshots, so the pair can be several steps apart
+    // and a single step is not the span to blend over.
+    const double step = GameWorld::FixedTimestep * 1e9;
+    double span = std::max(static_cast<double>(_current.stamp - _previous.stamp), 1.0);
+    double shown = Profiler::now() - step - _previous.stamp;
+    float alpha = static_cast<float>(std::min(std::max(shown / span, 0.0), 1.0));
+    WorldSnapshot::interpolate(_previous, _current, alpha, out);
+    return true;
+}
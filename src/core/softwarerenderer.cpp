@@ -0,0 +1,269 @@
+#include "softwarerenderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    const glm::vec3 bgColor{0.0f, 0.5f, 1.0f};
+    const glm::vec3 fgColor{1.0f, 1.0f, 1.0f};
+    const float lineRadius{0.006f};
+    const float posX{0.5f};
+
+    /* What a lane shows instead of the line: 1 for a pickup, Particle + kind for a particle. */
+    const int Particle{2};
+    const unsigned char itemColors[2 + ParticleSystem::KindCount][3] = {
+        {0, 0, 0},
+        {255, 255, 0},
+        // By ParticleSystem::Kind: collect, death, impact, splash.
+        {255, 255, 0},
+        {255, 255, 255},
+        {255, 204, 102},
+        {178, 230, 255},
+    };
+
+    float smoothstep(float edge0, float edge1, float x)
+    {
+        float t = std::min(std::max((x - edge0) / (edge1 - edge0), 0.0f), 1.0f);
+        return t * t * (3.0f - 2.0f * t);
+    }
+
+    /* An entity in the current column's bin, reduced to what varies by row. */
+    struct ColumnItem
+    {
+        int type;
+        float y;
+        float below;
+        float above;
+        float displacement;
+        float radius;
+        float dx;
+        int color;
+    };
+}
+
+SoftwareRenderer::SoftwareRenderer(std::shared_ptr<ThreadPool> threadPool) : _threadPool{threadPool}
+{
+    if(_threadPool == nullptr)
+    {
+        _threadPool = std::make_shared<ThreadPool>();
+    }
+}
+
+void SoftwareRenderer::render(const Frame& frame, std::vector<unsigned char>& rgb)
+{
+    rgb.resize(static_cast<size_t>(frame.resolution.x) * frame.resolution.y * 3);
+
+    TerrainColumns::Input terrain;
+    terrain.width = frame.resolution.x;
+    terrain.aspect = static_cast<float>(frame.resolution.x) / frame.resolution.y;
+    terrain.camera = frame.camera.x;
+    terrain.time = frame.time;
+    terrain.shake = frame.shake;
+    terrain.map = frame.map;
+    terrain.mapColumns = frame.mapColumns;
+    terrain.columnsPerUnit = frame.columnsPerUnit;
+    terrain.mapStride = frame.mapStride;
+    _terrain.build(terrain);
+
+    int tilesX = (frame.resolution.x + TileSize - 1) / TileSize;
+    int tilesY = (frame.resolution.y + TileSize - 1) / TileSize;
+    unsigned char* pixels = rgb.data();
+    _threadPool->parallelFor(static_cast<size_t>(tilesX) * tilesY, [&](size_t tile) {
+        renderTile(frame, static_cast<int>(tile % tilesX), static_cast<int>(tile / tilesX), pixels);
+    });
+}
+
+void SoftwareRenderer::renderTile(const Frame& frame, int tileX, int tileY, unsigned char* rgb) const
+{
+    thread_local std::vector<ColumnItem> items;
+
+    const int width = frame.resolution.x;
+    const int height = frame.resolution.y;
+    const float aspect = static_cast<float>(width) / height;
+    const bool facingLeft = frame.playerPos.z < 0;
+    const float delta = -frame.playerPos.x;
+    const float frtime = frame.time - std::floor(frame.time);
+    const float a = std::max(-frame.playerPos.y, 0.0f);
+
+    const int x0 = tileX * TileSize;
+    const int x1 = std::min(x0 + TileSize, width);
+    const int y0 = tileY * TileSize;
+    const int y1 = std::min(y0 + TileSize, height);
+
+    for(int px = x0; px < x1; ++px)
+    {
+        // Everything up to the entity loop depends on the column only.
+        float stx = (px + 0.5f) / width * aspect - 0.5f + frame.camera.x;
+        float dy = _terrain[px];
+
+        items.clear();
+        if(frame.bins != nullptr && frame.bins->binCount() > 0)
+        {
+            const ColumnBins& bins = *frame.bins;
+            int bin = bins.binOf(stx);
+            for(int i = bins.first(bin); i < bins.first(bin) + bins.count(bin); ++i)
+            {
+                const auto& texel = bins.item(i);
+                int flags = static_cast<int>(texel.w);
+                ColumnItem item{flags & 3, texel.y, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1};
+                if(item.type == ColumnBins::PROJECTILE)
+                {
+                    const float r = 0.05f;
+                    if(!(texel.x > stx - r && texel.x < stx + r))
+                    {
+                        continue;
+                    }
+                    item.below = r;
+                    item.above = r;
+                    item.displacement = -(std::cos(std::abs(stx - texel.x) / 0.025f) * 0.025f + 0.01f);
+                }
+                else if(item.type == ColumnBins::ENEMY)
+                {
+                    float r = 0.05f;
+                    if(texel.z > 0)
+                    {
+                        r *= texel.z / 0.4f;
+                    }
+                    if(!(texel.x > stx - r && texel.x < stx + r))
+                    {
+                        continue;
+                    }
+                    item.below = r * 2.5f;
+                    item.above = r;
+                    item.displacement = -(std::cos(std::abs(stx - texel.x) / (r * 0.5f)) * r * 1.5f + r * 0.68f);
+                    if((flags & ColumnBins::ChasingFlag) != 0 || frtime < 0.3f)
+                    {
+                        item.displacement += std::sin(stx * 64.0f * std::cos(27.0f * stx) * frame.time) * 0.01f * (frtime + 0.2f);
+                    }
+                }
+                else if(item.type == ColumnBins::COLLECTABLE)
+                {
+                    float r = 0.008f + std::sin(frame.time * 8.0f) * 0.002f + 0.001f;
+                    if(!(texel.x > stx - r && texel.x < stx + r))
+                    {
+                        continue;
+                    }
+                    item.y += std::sin(frame.time * 8.0f) * 0.01f;
+                    item.below = r;
+                    item.above = r;
+                    item.radius = r + 0.0016f;
+                    item.dx = texel.x - stx;
+                }
+                else
+                {
+                    float r = ColumnBins::ParticleRadius * texel.z;
+                    if(!(texel.x > stx - r && texel.x < stx + r))
+                    {
+                        continue;
+                    }
+                    item.below = r;
+                    item.above = r;
+                    item.radius = r;
+                    item.dx = texel.x - stx;
+                    item.color = Particle + (flags >> ColumnBins::ParticleKindShift);
+                }
+                items.push_back(item);
+            }
+        }
+
+        const float sx = stx + delta;
+        const float bend = std::sin(sx * 10.0f) * 0.15f - frame.playerPos.y;
+
+        for(int py = y0; py < y1; py += Lanes)
+        {
+            float sty[Lanes];
+            int picked[Lanes];
+            for(int l = 0; l < Lanes; ++l)
+            {
+                sty[l] = 1.0f - (py + l + 0.5f) / height + dy;
+                picked[l] = 0;
+            }
+
+            for(const auto& item : items)
+            {
+                if(item.type == ColumnBins::COLLECTABLE || item.type == ColumnBins::PARTICLE)
+                {
+                    for(int l = 0; l < Lanes; ++l)
+                    {
+                        float ddy = item.y - sty[l];
+                        bool hit = item.y > sty[l] - item.below && item.y < sty[l] + item.above
+                            && std::sqrt(item.dx * item.dx + ddy * ddy) < item.radius;
+                        // The shader returns on the first hit, so later items cannot recolor a lane.
+                        picked[l] = hit && picked[l] == 0 ? item.color : picked[l];
+                    }
+                }
+                else
+                {
+                    for(int l = 0; l < Lanes; ++l)
+                    {
+                        bool hit = item.y > sty[l] - item.below && item.y < sty[l] + item.above;
+                        // Lanes already showing a pickup or particle have returned in the shader.
+                        sty[l] += hit && picked[l] == 0 ? item.displacement : 0.0f;
+                    }
+                }
+            }
+
+            const int rows = std::min(Lanes, y1 - py);
+            for(int l = 0; l < rows; ++l)
+            {
+                unsigned char* out = rgb + (static_cast<size_t>(py + l) * width + px) * 3;
+                if(picked[l] != 0)
+                {
+                    out[0] = itemColors[picked[l]][0];
+                    out[1] = itemColors[picked[l]][1];
+                    out[2] = itemColors[picked[l]][2];
+                    continue;
+                }
+
+                float k = smoothstep(0.58f, 0.61f, sty[l] - frame.playerPos.y);
+                float left = facingLeft ? 0.04f + a + k * 0.08f : 0.07f + a;
+                float right = facingLeft ? 0.07f + a : 0.04f + a + k * 0.16f;
+                float w = smoothstep(posX - left, posX, sx) - smoothstep(posX, posX + right, sx);
+                float y = sty[l] + w * bend;
+
+                float x = smoothstep(0.5f, 0.501f, std::abs(y + lineRadius))
+                    - smoothstep(0.5f, 0.501f, std::abs(y - lineRadius));
+
+                for(int c = 0; c < 3; ++c)
+                {
+                    float color = bgColor[c] + (fgColor[c] - bgColor[c]) * x;
+                    color = color + (1.0f - 2.0f * color) * frame.shake;
+                    out[c] = static_cast<unsigned char>(std::min(std::max(color, 0.0f), 1.0f) * 255.0f + 0.5f);
+                }
+            }
+        }
+    }
+}
+
+bool SoftwareRenderer::writePpm(const std::string& path, const std::vector<unsigned char>& rgb, const glm::ivec2& resolution)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if(file == nullptr)
+    {
+        return false;
+    }
+    fprintf(file, "P6\n%d %d\n255\n", resolution.x, resolution.y);
+    bool ok = fwrite(rgb.data(), 1, rgb.size(), file) == rgb.size();
+    return fclose(file) == 0 && ok;
+}
+
+bool SoftwareRenderer::readPpm(const std::string& path, std::vector<unsigned char>& rgb, glm::ivec2& resolution)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if(file == nullptr)
+    {
+        return false;
+    }
+    int maxValue{0};
+    bool ok = fscanf(file, "P6 %d %d %d", &resolution.x, &resolution.y, &maxValue) == 3 && fgetc(file) != EOF
+        && maxValue == 255 && resolution.x > 0 && resolution.y > 0;
+    if(ok)
+    {
+        rgb.resize(static_cast<size_t>(resolution.x) * resolution.y * 3);
+        ok = fread(rgb.data(), 1, rgb.size(), file) == rgb.size();
+    }
+    fclose(file);
+    return ok;
+}
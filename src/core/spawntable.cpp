@@ -0,0 +1,128 @@
+#include "spawntable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+SpawnTable::Entry SpawnTable::pack(const Spawn& spawn)
+{
+    double x = std::round((static_cast<double>(spawn.position.x) - MinX) * Resolution);
+    double y = std::round(static_cast<double>(spawn.position.y) * Resolution);
+    Entry entry{};
+    entry.x = static_cast<uint32_t>(std::min(std::max(x, 0.0), static_cast<double>(UINT32_MAX)));
+    entry.y = static_cast<int16_t>(std::min(std::max(y, static_cast<double>(INT16_MIN)), static_cast<double>(INT16_MAX)));
+    entry.type = spawn.type;
+    return entry;
+}
+
+std::vector<SpawnTable::Entry> SpawnTable::build(const std::vector<Spawn>& spawns)
+{
+    std::vector<Entry> entries;
+    entries.reserve(spawns.size());
+    for(const Spawn& spawn : spawns)
+    {
+        entries.push_back(pack(spawn));
+    }
+    // Stable, so spawns at the same x keep their authored order and handles come out the same.
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.x < b.x;
+    });
+    return entries;
+}
+
+bool SpawnTable::parse(const std::string& path, std::vector<Spawn>& spawns, int& line)
+{
+    line = 0;
+    std::FILE* file = std::fopen(path.c_str(), "r");
+    if(file == nullptr)
+    {
+        return false;
+    }
+    char text[256];
+    bool ok{true};
+    while(ok && std::fgets(text, sizeof(text), file) != nullptr)
+    {
+        ++line;
+        char type[32];
+        float x;
+        float y;
+        int fields = std::sscanf(text, "%31s %f %f", type, &x, &y);
+        if(fields <= 0 || type[0] == '#')
+        {
+            continue;
+        }
+        if(fields == 3 && std::strcmp(type, "collectable") == 0)
+        {
+            spawns.push_back(Spawn{Type::COLLECTABLE, glm::vec2(x, y)});
+        }
+        else if(fields == 3 && std::strcmp(type, "enemy") == 0)
+        {
+            spawns.push_back(Spawn{Type::ENEMY, glm::vec2(x, y)});
+        }
+        else
+        {
+            ok = false;
+        }
+    }
+    std::fclose(file);
+    return ok;
+}
+
+bool SpawnTable::write(const std::string& path, const std::vector<Spawn>& spawns)
+{
+    std::vector<Entry> entries = build(spawns);
+    return write(path, entries.data(), entries.size());
+}
+
+bool SpawnTable::write(const std::string& path, const Entry* entries, size_t count)
+{
+    Header header{Magic, Version, count};
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if(file == nullptr)
+    {
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(Header), 1, file) == 1
+        && std::fwrite(entries, sizeof(Entry), count, file) == count;
+    return std::fclose(file) == 0 && ok;
+}
+
+bool SpawnTable::open(const std::string& path)
+{
+    close();
+    if(!_file.open(path) || _file.size() < sizeof(Header))
+    {
+        close();
+        return false;
+    }
+    Header header;
+    std::memcpy(&header, _file.data(), sizeof(Header));
+    if(header.magic != Magic || header.version != Version
+        || header.count > (_file.size() - sizeof(Header)) / sizeof(Entry))
+    {
+        close();
+        return false;
+    }
+    // Streaming reads a region's entries at a time; skip the read-ahead.
+    _file.advise(0, _file.size(), MappedFile::Advice::RANDOM);
+    _entries = reinterpret_cast<const Entry*>(_file.data() + sizeof(Header));
+    _count = static_cast<size_t>(header.count);
+    return true;
+}
+
+void SpawnTable::assign(const std::vector<Spawn>& spawns)
+{
+    close();
+    _owned = build(spawns);
+    _entries = _owned.data();
+    _count = _owned.size();
+}
+
+void SpawnTable::close()
+{
+    _file.close();
+    _owned.clear();
+    _entries = nullptr;
+    _count = 0;
+}
@@ -0,0 +1,99 @@
+#include "startuploader.h"
+
+#include <algorithm>
+#include "profiler.h"
+
+StartupLoader::StartupLoader() : _begin{Profiler::now()}
+{
+}
+
+StartupLoader::~StartupLoader() noexcept
+{
+    for(auto& thread : _threads)
+    {
+        if(thread.joinable())
+        {
+            thread.join();
+        }
+    }
+}
+
+StartupLoader::Task StartupLoader::start(const char* name, std::function<void()> job)
+{
+    _taskNames.push_back(name);
+    _threads.emplace_back([this, name, job = std::move(job)]() {
+        uint64_t begin = Profiler::now();
+        job();
+        uint64_t end = Profiler::now();
+        Profiler::record(name, begin, end);
+        std::lock_guard<std::mutex> lock{_mutex};
+        _phases.push_back(Phase{name, Kind::WORKER, begin, end});
+    });
+    return _threads.size() - 1;
+}
+
+void StartupLoader::join(Task task)
+{
+    if(task >= _threads.size() || !_threads[task].joinable())
+    {
+        return;
+    }
+    uint64_t begin = Profiler::now();
+    _threads[task].join();
+    uint64_t end = Profiler::now();
+    std::lock_guard<std::mutex> lock{_mutex};
+    _phases.push_back(Phase{_taskNames[task], Kind::WAIT, begin, end});
+}
+
+void StartupLoader::phase(const char* name)
+{
+    uint64_t now = Profiler::now();
+    endPhase(now);
+    _current = name;
+    _currentBegin = now;
+}
+
+void StartupLoader::finish()
+{
+    if(_finished)
+    {
+        return;
+    }
+    _end = Profiler::now();
+    endPhase(_end);
+    _current = nullptr;
+    _finished = true;
+}
+
+std::vector<StartupLoader::Phase> StartupLoader::phases() const
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    return _phases;
+}
+
+void StartupLoader::printBreakdown(std::FILE* out) const
+{
+    std::fprintf(out, "startup: %.1f ms to first frame\n", total() * 1e-6);
+    std::fprintf(out, "  %-20s %-8s %10s %10s\n", "phase", "thread", "start ms", "ms");
+    std::vector<Phase> sorted = phases();
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Phase& a, const Phase& b) {
+        return a.begin < b.begin;
+    });
+    for(const Phase& phase : sorted)
+    {
+        const char* kind = phase.kind == Kind::MAIN ? "main" : phase.kind == Kind::WORKER ? "worker" : "wait";
+        std::fprintf(out, "  %-20s %-8s %10.2f %10.2f\n", phase.name, kind, (phase.begin - _begin) * 1e-6,
+            (phase.end - phase.begin) * 1e-6);
+    }
+}
+
+void StartupLoader::endPhase(uint64_t now)
+{
+    if(_current == nullptr)
+    {
+        return;
+    }
+    Profiler::record(_current, _currentBegin, now);
+    std::lock_guard<std::mutex> lock{_mutex};
+    _phases.push_back(Phase{_current, Kind::MAIN, _currentBegin, now});
+}
@@ -0,0 +1,73 @@
+#include "sweepindex.h"
+
+#include <algorithm>
+#include <cmath>
+
+void SweepIndex::rebuild(const glm::vec2* positions, size_t count)
+{
+    if(_order.size() != count)
+    {
+        // Pool membership changed shape; start over from a full sort.
+        _order.resize(count);
+        for(size_t i = 0; i < count; ++i)
+        {
+            _order[i] = static_cast<uint32_t>(i);
+        }
+        std::sort(_order.begin(), _order.end(), [positions](uint32_t a, uint32_t b) {
+            return positions[a].x < positions[b].x;
+        });
+    }
+    else
+    {
+        // Insertion sort is linear for coherent motion. Bail out to a full sort
+        // when the old order turns out to be a poor hint.
+        const size_t moveBudget = count * 8 + 64;
+        size_t moves{0};
+        for(size_t i = 1; i < count && moves <= moveBudget; ++i)
+        {
+            uint32_t index = _order[i];
+            float x = positions[index].x;
+            size_t j = i;
+            while(j > 0 && positions[_order[j - 1]].x > x)
+            {
+                _order[j] = _order[j - 1];
+                --j;
+                ++moves;
+            }
+            _order[j] = index;
+        }
+        if(moves > moveBudget)
+        {
+            std::sort(_order.begin(), _order.end(), [positions](uint32_t a, uint32_t b) {
+                return positions[a].x < positions[b].x;
+            });
+        }
+    }
+
+    _xs.resize(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        _xs[i] = positions[_order[i]].x;
+    }
+}
+
+int SweepIndex::firstWithin(const glm::vec2& point, float radiusSquared, const glm::vec2* positions) const
+{
+    // Pad the range so float rounding never drops a pair the exact test accepts.
+    float radius = std::sqrt(radiusSquared) * 1.001f;
+    int first{-1};
+    query(point.x - radius, point.x + radius, [&](uint32_t index) {
+        glm::vec2 delta = point - positions[index];
+        if(delta.x * delta.x + delta.y * delta.y < radiusSquared
+            && (first < 0 || static_cast<int>(index) < first))
+        {
+            first = static_cast<int>(index);
+        }
+    });
+    return first;
+}
+
+size_t SweepIndex::lowerBound(float x) const
+{
+    return std::lower_bound(_xs.begin(), _xs.end(), x) - _xs.begin();
+}
@@ -0,0 +1,153 @@
+#include "terrain.h"
+
+#include <algorithm>
+#include <cmath>
+
+void Terrain::build(const unsigned char* bytes, size_t columns, int stride, float columnsPerUnit)
+{
+    _bytes = bytes;
+    _columns = bytes != nullptr ? columns : 0;
+    _stride = stride;
+    _columnsPerUnit = columnsPerUnit;
+    for(Chunk& chunk : _chunks)
+    {
+        chunk.index = SIZE_MAX;
+    }
+}
+
+void Terrain::update(size_t first, size_t count)
+{
+    if(count == 0)
+    {
+        return;
+    }
+    // A run may continue over the chunk edge, but each chunk's runs stop at
+    // it, so only the chunks holding the edit are stale.
+    size_t firstChunk = first / ChunkColumns;
+    size_t lastChunk = (first + count - 1) / ChunkColumns;
+    for(Chunk& chunk : _chunks)
+    {
+        if(chunk.index >= firstChunk && chunk.index <= lastChunk)
+        {
+            chunk.index = SIZE_MAX;
+        }
+    }
+}
+
+const Terrain::Chunk& Terrain::chunk(size_t index) const
+{
+    Chunk* oldest = &_chunks[0];
+    for(Chunk& chunk : _chunks)
+    {
+        if(chunk.index == index)
+        {
+            chunk.used = ++_uses;
+            return chunk;
+        }
+        oldest = chunk.used < oldest->used ? &chunk : oldest;
+    }
+
+    // Room for the most runs a chunk can hold, once per slot, keeps
+    // re-indexing off the heap.
+    Chunk& chunk = *oldest;
+    chunk.index = index;
+    chunk.used = ++_uses;
+    chunk.water.clear();
+    chunk.water.reserve(ChunkColumns / 2);
+    size_t end = std::min((index + 1) * ChunkColumns, _columns);
+    for(size_t c = index * ChunkColumns; c < end; ++c)
+    {
+        if(!waterColumn(c))
+        {
+            continue;
+        }
+        if(!chunk.water.empty() && chunk.water.back().last + 1 == c)
+        {
+            chunk.water.back().last = static_cast<uint32_t>(c);
+        }
+        else
+        {
+            chunk.water.push_back(WaterSpan{static_cast<uint32_t>(c), static_cast<uint32_t>(c)});
+        }
+    }
+    return chunk;
+}
+
+const std::vector<Terrain::WaterSpan>& Terrain::water(size_t column) const
+{
+    return chunk(column / ChunkColumns).water;
+}
+
+float Terrain::height(float x) const
+{
+    float out;
+    heights(&x, &out, 1);
+    return out;
+}
+
+float Terrain::slope(float x) const
+{
+    if(_columns < 2)
+    {
+        return 0.0f;
+    }
+    double t = columnCoordinate(x);
+    if(t <= 0.0 || t >= _columns - 1)
+    {
+        return 0.0f;
+    }
+    size_t i = static_cast<size_t>(t);
+    return static_cast<float>((columnHeight(i + 1) - columnHeight(i)) * _columnsPerUnit);
+}
+
+bool Terrain::waterBetween(float x0, float x1) const
+{
+    if(_columns == 0)
+    {
+        return false;
+    }
+    size_t first = column(std::min(x0, x1));
+    size_t last = column(std::max(x0, x1));
+    for(size_t index = first / ChunkColumns; index <= last / ChunkColumns; ++index)
+    {
+        const std::vector<WaterSpan>& water = chunk(index).water;
+        auto span = std::lower_bound(water.begin(), water.end(), first, [](const WaterSpan& span, size_t column) {
+            return span.last < column;
+        });
+        if(span != water.end() && span->first <= last)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Terrain::heights(const float* xs, float* out, size_t count) const
+{
+    if(_columns == 0)
+    {
+        std::fill(out, out + count, 0.0f);
+        return;
+    }
+    const double maxT = static_cast<double>(_columns - 1);
+    for(size_t i = 0; i < count; i += Lanes)
+    {
+        const size_t n = std::min<size_t>(Lanes, count - i);
+        size_t i0[Lanes];
+        float f[Lanes];
+        for(size_t l = 0; l < n; ++l)
+        {
+            double t = std::min(std::max(columnCoordinate(xs[i + l]), 0.0), maxT);
+            double t0 = std::floor(t);
+            i0[l] = static_cast<size_t>(t0);
+            f[l] = static_cast<float>(t - t0);
+        }
+        for(size_t l = 0; l < n; ++l)
+        {
+            // At the last column f is zero, so reading it twice is harmless.
+            size_t i1 = std::min(i0[l] + 1, _columns - 1);
+            float h0 = columnHeight(i0[l]);
+            out[i + l] = h0 + (columnHeight(i1) - h0) * f[l];
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#include "terraincolumns.h"
+
+#include <cmath>
+#include "gameworld.h"
+
+void TerrainColumns::build(const Input& input)
+{
+    _displacement.resize(input.width);
+    for(int column = 0; column < input.width; ++column)
+    {
+        _displacement[column] = displacement(input, columnX(input, column));
+    }
+}
+
+float TerrainColumns::columnX(const Input& input, int column)
+{
+    return (column + 0.5f) / input.width * input.aspect - 0.5f + input.camera;
+}
+
+float TerrainColumns::displacement(const Input& input, float x)
+{
+    glm::vec2 sample = sampleMap(input, x);
+    return std::sin(x * 64.0f * std::cos(27.0f * x) * input.shake) * 0.01f * input.shake
+        - (sample.x - 0.5f)
+        + waveSuperposition(x, input.time) * sample.y;
+}
+
+float TerrainColumns::waveSuperposition(float x, float time)
+{
+    static const float frequencies[3] = {2.0f, 4.0f, 0.5f};
+    static const float amplitudes[3] = {0.002f, 0.001f, 0.003f};
+    static const float phases[3] = {0.0f, 1.0f, 0.5f};
+
+    float y = 0.0f;
+    for(int j = 0; j < 3; ++j)
+    {
+        y += amplitudes[j] * std::sin(frequencies[j] * 12.0f * x * 2.0f * glm::pi<float>() + phases[j] * time * 16.0f);
+    }
+    return y;
+}
+
+glm::vec2 TerrainColumns::sampleMap(const Input& input, float x)
+{
+    if(input.map == nullptr || input.mapColumns == 0)
+    {
+        return glm::vec2(0.5f, 0.0f);
+    }
+    double columnsPerUnit = input.columnsPerUnit > 0.0f ? input.columnsPerUnit
+        : input.mapColumns / static_cast<double>(GameWorld::LegacyLevelUnits);
+    double texel = x * columnsPerUnit - 0.5;
+    double t0 = std::floor(texel);
+    float f = static_cast<float>(texel - t0);
+    long long columns = static_cast<long long>(input.mapColumns);
+    long long i0 = static_cast<long long>(t0) % columns;
+    i0 += i0 < 0 ? columns : 0;
+    long long i1 = (i0 + 1) % columns;
+    const unsigned char* a = input.map + i0 * input.mapStride;
+    const unsigned char* b = input.map + i1 * input.mapStride;
+    return glm::vec2(
+        (a[0] + (b[0] - a[0]) * f) / 255.0f,
+        (a[2] + (b[2] - a[2]) * f) / 255.0f);
+}
@@ -0,0 +1,79 @@
+#include "threadpool.h"
+
+ThreadPool::ThreadPool(unsigned threads)
+{
+    unsigned workers = threads > 1 ? threads - 1 : 0;
+    for(unsigned i = 0; i < workers; ++i)
+    {
+        _workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for(auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& job)
+{
+    if(count == 0)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _job = &job;
+        _count = count;
+        _next = 0;
+        ++_generation;
+    }
+    _wake.notify_all();
+
+    drain();
+
+    std::unique_lock<std::mutex> lock{_mutex};
+    _done.wait(lock, [this]() { return _busy == 0; });
+    // Workers that wake up late must not pick up a finished job.
+    _job = nullptr;
+}
+
+void ThreadPool::workerLoop()
+{
+    unsigned long long seen{0};
+    std::unique_lock<std::mutex> lock{_mutex};
+    while(true)
+    {
+        _wake.wait(lock, [&]() { return _stopping || (_job != nullptr && _generation != seen); });
+        if(_stopping)
+        {
+            return;
+        }
+        seen = _generation;
+        ++_busy;
+        lock.unlock();
+
+        drain();
+
+        lock.lock();
+        if(--_busy == 0)
+        {
+            _done.notify_all();
+        }
+    }
+}
+
+void ThreadPool::drain()
+{
+    for(size_t i = _next.fetch_add(1); i < _count; i = _next.fetch_add(1))
+    {
+        (*_job)(i);
+    }
+}
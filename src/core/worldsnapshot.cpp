@@ -0,0 +1,64 @@
+#include "worldsnapshot.h"
+
+#include <algorithm>
+
+namespace
+{
+    void blend(const std::vector<glm::vec2>& fromPositions, const std::vector<uint32_t>& fromHandles,
+        const std::vector<glm::vec2>& toPositions, const std::vector<uint32_t>& toHandles, float alpha,
+        std::vector<glm::vec2>& out)
+    {
+        out.assign(toPositions.begin(), toPositions.end());
+        size_t shared = std::min(fromHandles.size(), toHandles.size());
+        for(size_t i = 0; i < shared; ++i)
+        {
+            if(fromHandles[i] == toHandles[i])
+            {
+                out[i] = glm::mix(fromPositions[i], toPositions[i], alpha);
+            }
+        }
+    }
+}
+
+void WorldSnapshot::interpolate(const WorldSnapshot& a, const WorldSnapshot& b, float alpha, WorldSnapshot& out)
+{
+    out.time = glm::mix(a.time, b.time, alpha);
+    out.ticks = b.ticks;
+    out.stamp = b.stamp;
+    out.inputStamp = b.inputStamp;
+    out.playerPos = glm::vec3(glm::mix(glm::vec2(a.playerPos), glm::vec2(b.playerPos), alpha), b.playerPos.z);
+    out.camera2d = glm::mix(a.camera2d, b.camera2d, alpha);
+    out.shake = b.shake;
+
+    out.projectilePositions.reserve(GameWorld::MaxProjectiles);
+    out.projectileHandles.reserve(GameWorld::MaxProjectiles);
+    blend(a.projectilePositions, a.projectileHandles, b.projectilePositions, b.projectileHandles, alpha,
+        out.projectilePositions);
+    out.projectileHandles = b.projectileHandles;
+
+    // Room for whatever b can hold, so entities waking up do not grow out.
+    out.enemyPositions.reserve(b.enemyPositions.capacity());
+    out.enemies.reserve(b.enemies.capacity());
+    out.enemyHandles.reserve(b.enemyHandles.capacity());
+    out.collectablePositions.reserve(b.collectablePositions.capacity());
+    out.collectables.reserve(b.collectables.capacity());
+    out.collectableHandles.reserve(b.collectableHandles.capacity());
+    blend(a.enemyPositions, a.enemyHandles, b.enemyPositions, b.enemyHandles, alpha, out.enemyPositions);
+    out.enemies = b.enemies;
+    out.enemyHandles = b.enemyHandles;
+
+    blend(a.collectablePositions, a.collectableHandles, b.collectablePositions, b.collectableHandles, alpha,
+        out.collectablePositions);
+    out.collectables = b.collectables;
+    out.collectableHandles = b.collectableHandles;
+
+    // Particles have no handles and expiring ones are replaced from the end,
+    // so nothing pairs them across snapshots; they show as of b, at most a
+    // step behind, which is not visible on anything this small and brief.
+    out.particlePositions.reserve(b.particlePositions.capacity());
+    out.particleFades.reserve(b.particleFades.capacity());
+    out.particleKinds.reserve(b.particleKinds.capacity());
+    out.particlePositions = b.particlePositions;
+    out.particleFades = b.particleFades;
+    out.particleKinds = b.particleKinds;
+}
@@ -0,0 +1,78 @@
+#include "entityuniforms.h"
+
+#include <cstring>
+
+EntityUniforms::~EntityUniforms() noexcept
+{
+    if(_buffer)
+    {
+        glDeleteBuffers(1, &_buffer);
+    }
+}
+
+void EntityUniforms::bind(lithium::ShaderProgram* shaderProgram)
+{
+    _program = shaderProgram->id();
+    _forceUpload = true;
+    _frameStats = Stats{};
+
+    if(!_buffer)
+    {
+        glGenBuffers(1, &_buffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, FrameBinding, _buffer);
+
+    GLuint block = glGetUniformBlockIndex(_program, "Frame");
+    ++_frameStats.lookups;
+    if(block != GL_INVALID_INDEX)
+    {
+        glUniformBlockBinding(_program, block, FrameBinding);
+    }
+
+    // Samplers can not live in a uniform block; their units never change.
+    GLint bins = glGetUniformLocation(_program, "u_bins");
+    GLint terrain = glGetUniformLocation(_program, "u_terrain");
+    _frameStats.lookups += 2;
+    glUniform1i(bins, BinTextureUnit);
+    glUniform1i(terrain, TerrainTextureUnit);
+}
+
+void EntityUniforms::pack(const WorldSnapshot& world, const ColumnBins& bins, const glm::vec2& resolution, float time, FrameUniforms& packed)
+{
+    packed.camera = world.camera2d;
+    packed.binOrigin = bins.origin();
+    packed.binWidth = bins.binWidth();
+    packed.playerPos = world.playerPos;
+    packed.shake = world.shake;
+    packed.resolution = resolution;
+    packed.time = time;
+    packed.binCount = bins.binCount();
+}
+
+void EntityUniforms::upload(const WorldSnapshot& world, const ColumnBins& bins, const glm::vec2& resolution, float time)
+{
+    int lookups = _frameStats.lookups;
+    _frameStats = Stats{};
+    if(_forceUpload)
+    {
+        // Report the lookups done by bind() with the first frame that uses them.
+        _frameStats.lookups = lookups;
+    }
+
+    pack(world, bins, resolution, time, _current);
+    if(_forceUpload || std::memcmp(&_current, &_uploaded, sizeof(FrameUniforms)) != 0)
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &_current);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        _uploaded = _current;
+        ++_frameStats.uploads;
+    }
+    // Another program may have claimed the binding point since the last frame.
+    glBindBufferBase(GL_UNIFORM_BUFFER, FrameBinding, _buffer);
+
+    _forceUpload = false;
+}
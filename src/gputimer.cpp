@@ -0,0 +1,43 @@
+#include "gputimer.h"
+
+GpuTimer::GpuTimer()
+{
+    glGenQueries(Latency, _queries);
+}
+
+GpuTimer::~GpuTimer() noexcept
+{
+    glDeleteQueries(Latency, _queries);
+}
+
+void GpuTimer::begin()
+{
+    glBeginQuery(GL_TIME_ELAPSED, _queries[_next]);
+}
+
+void GpuTimer::end()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    _pending[_next] = true;
+    _next = (_next + 1) % Latency;
+}
+
+float GpuTimer::poll()
+{
+    // The oldest query in the ring is the next one to be reused.
+    int oldest = _next;
+    if(!_pending[oldest])
+    {
+        return -1.0f;
+    }
+    GLint available{0};
+    glGetQueryObjectiv(_queries[oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+    if(!available)
+    {
+        return -1.0f;
+    }
+    GLuint64 elapsed{0};
+    glGetQueryObjectui64v(_queries[oldest], GL_QUERY_RESULT, &elapsed);
+    _pending[oldest] = false;
+    return static_cast<float>(elapsed * 1e-6);
+}
@@ -1,9 +1,31 @@
 #include "app.h"
 
+#include <cstring>
 
 int main(int argc, const char* argv[])
 {
-    std::unique_ptr<App> app = std::make_unique<App>();
+    // susjam23 [level.sjl] [--record session.sjr]
+    std::string levelPath;
+    std::string recordPath;
+    for(int i = 1; i < argc; ++i)
+    {
+        if(strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            recordPath = argv[++i];
+        }
+        else
+        {
+            levelPath = argv[i];
+        }
+    }
+
+    // Decode the level and build shader sources while the window and context are created.
+    // Assets outlive the loader, which joins any task still running when it goes.
+    App::Assets assets;
+    StartupLoader startup;
+    assets.start(startup, levelPath);
+    startup.phase("window");
+    std::unique_ptr<App> app = std::make_unique<App>(startup, assets, recordPath);
     app->run();
     return 0;
 }
\ No newline at end of file
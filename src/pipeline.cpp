@@ -1,5 +1,8 @@
 #include "pipeline.h"
+
 #include "glplane.h"
+#include "frameuniforms.h"
+#include "profiler.h"
 
 namespace
 {
@@ -14,62 +17,25 @@ void main()
 }
 )";
 
-    const char* fragSrc = R"(#version 330 core
+    // The Frame block and the bin constants are generated by frameDeclarations().
+    const char* fragVersion = "#version 330 core\n";
 
+    const char* fragSrc = R"(
 out vec4 fragColor;
 in vec2 texCoord;
 
-struct Projectile
-{
-    vec2 position;
-    vec2 velocity;
-    bool used;
-};
+// Line displacement per framebuffer column from the terrain pass.
+uniform samplerBuffer u_terrain;
 
-struct Collectable
-{
-    vec2 position;
-    bool used;
-};
-
-struct Enemy
-{
-    vec2 position;
-    bool used;
-    bool facingLeft;
-    bool chasingPlayer;
-    float deathTimer;
-};
-
-uniform vec2 u_camera;
-uniform vec2 u_resolution;
-uniform float u_time;
-uniform vec3 u_playerPos;
-uniform float u_shake;
-uniform Projectile u_projectiles[10];
-uniform Collectable u_collectables[10];
-uniform Enemy u_enemies[10];
-uniform sampler2D u_map;
+// Entities and particles binned by screen column: headers (first, count) then items (x, y, deathTimer or fade, flags).
+uniform samplerBuffer u_bins;
 
 const vec3 bgColor = vec3(0.0, 0.5, 1.0);
 const vec3 fgColor = vec3(1.0, 1.0, 1.0);
 const float lineRadius = 0.006;
 
-float waveSuperposition(float x) {
-    float y = 0.0;
-
-    // Define wave properties
-    float frequencies[3] = float[](2.0, 4.0, 0.5);
-    float amplitudes[3] = float[](0.002, 0.001, 0.003);
-    float phases[3] = float[](0.0, 1.0, 0.5);
-
-    // Sum multiple sine waves
-    for (int j = 0; j < 3; ++j) {
-        y += amplitudes[j] * sin(frequencies[j] * 12.0 * x * 2.0 * 3.1415926535897932384626433832795 + phases[j] * u_time * 16.0);
-    }
-
-    return y;
-}
+// By ParticleSystem::Kind: collect, death, impact, splash.
+const vec3 particleColors[4] = vec3[4](vec3(1.0, 1.0, 0.0), vec3(1.0, 1.0, 1.0), vec3(1.0, 0.8, 0.4), vec3(0.7, 0.9, 1.0));
 
 void main()
 {
@@ -86,22 +52,23 @@ void main()
 
     st.x += u_camera.x;
 
-    vec4 sample = texture(u_map, vec2(st.x / 4.0, 0.0));
-
-    st.y += sin(st.x * 64.0 * cos(27.0 * st.x) * u_shake) * 0.01 * u_shake;
+    st.y += texelFetch(u_terrain, int(gl_FragCoord.x)).r;
 
-    st.y -= sample.r - 0.5;
+    int bin = clamp(int(floor((st.x - u_binOrigin) / u_binWidth)), 0, u_binCount - 1);
+    vec4 header = texelFetch(u_bins, bin);
+    int first = int(header.x);
+    int last = first + int(header.y);
 
-    st.y += waveSuperposition(st.x) * sample.b;
-
-    float projectileRadius = 0.05;
-    for(int i=0; i < 10; ++i)
+    float projectileRadius = PROJECTILE_RADIUS;
+    for(int i=first; i < last; ++i)
     {
-        if(u_projectiles[i].used)
-        {
-            vec2 p = u_projectiles[i].position + 0.5;
-            vec2 v = u_projectiles[i].velocity;
+        vec4 item = texelFetch(u_bins, i);
+        int flags = int(item.w);
+        int type = flags & 3;
+        vec2 p = item.xy;
 
+        if(type == PROJECTILE)
+        {
             if(p.x > st.x - projectileRadius && p.x < st.x + projectileRadius)
             {
                 if(p.y > st.y - projectileRadius && p.y < st.y + projectileRadius)
@@ -110,19 +77,15 @@ void main()
                 }
             }
         }
-    }
-
-    for(int i=0; i < 10; ++i)
-    {
-        float enemyRadius = 0.05;
-        float scale = u_enemies[i].deathTimer / 0.4;
-        if(u_enemies[i].deathTimer > 0)
+        else if(type == ENEMY)
         {
-            enemyRadius *= scale;
-        }
-        if(u_enemies[i].used)
-        {
-            vec2 p = u_enemies[i].position + 0.5;
+            float enemyRadius = ENEMY_RADIUS;
+            float deathTimer = item.z;
+            float scale = deathTimer / 0.4;
+            if(deathTimer > 0)
+            {
+                enemyRadius *= scale;
+            }
 
             if(p.x > st.x - enemyRadius && p.x < st.x + enemyRadius)
             {
@@ -130,21 +93,16 @@ void main()
                 {
                     st.y -= cos(abs(st.x - p.x) / (enemyRadius * 0.5)) * enemyRadius * 1.5 + enemyRadius * 0.68;
                     float frtime = fract(u_time);
-                    if(u_enemies[i].chasingPlayer || frtime < 0.3)
+                    if((flags & CHASING) != 0 || frtime < 0.3)
                     {
                         st.y += sin(st.x * 64.0 * cos(27.0 * st.x) * u_time) * 0.01 * (frtime + 0.2);
                     }
                 }
             }
         }
-    }
-
-    for(int i=0; i < 10; ++i)
-    {
-        float collectableRadius = 0.008;
-        if(u_collectables[i].used)
+        else if(type == COLLECTABLE)
         {
-            vec2 p = u_collectables[i].position + 0.5;
+            float collectableRadius = 0.008;
             p.y += sin(u_time * 8.0) * 0.01;
             collectableRadius += sin(u_time * 8.0) * 0.002 + 0.001;
             vec2 d = p - st;
@@ -160,6 +118,19 @@ void main()
                 }
             }
         }
+        else if(type == PARTICLE)
+        {
+            // Shrinks away as it fades.
+            float particleRadius = PARTICLE_RADIUS * item.z;
+            if(p.x > st.x - particleRadius && p.x < st.x + particleRadius)
+            {
+                if(p.y > st.y - particleRadius && p.y < st.y + particleRadius && length(p - st) < particleRadius)
+                {
+                    fragColor = vec4(particleColors[flags >> PARTICLE_KIND_SHIFT], 1.0);
+                    return;
+                }
+            }
+        }
     }
 
     st.x += delta;
@@ -176,11 +147,37 @@ void main()
     fragColor = vec4(mix(bgColor, fgColor, x), 1.0);
     fragColor.rgb = mix(fragColor.rgb, 1.0 - fragColor.rgb, u_shake);
 }
+)";
+
+    // Stretches the internal target over the window with a single triangle.
+    const char* upscaleVertSrc = R"(#version 330 core
+out vec2 texCoord;
+void main()
+{
+    vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    texCoord = p;
+    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+    const char* upscaleFragSrc = R"(#version 330 core
+out vec4 fragColor;
+in vec2 texCoord;
+uniform sampler2D u_scene;
+void main()
+{
+    fragColor = texture(u_scene, texCoord);
+}
 )";
 
 }
 
-Pipeline::Pipeline(const glm::ivec2& resolution) : lithium::RenderPipeline{resolution},
+std::string Pipeline::screenFragmentSource()
+{
+    return std::string(fragVersion) + frameDeclarations() + fragSrc;
+}
+
+Pipeline::Pipeline(const glm::ivec2& resolution, const std::string& screenFragSrc) : lithium::RenderPipeline{resolution},
     _camera{new lithium::SimpleCamera(glm::perspective(glm::radians(45.0f), (float)resolution.x / (float)resolution.y, 0.1f, 100.0f))}
 {
     enableDepthTesting();
@@ -192,7 +189,7 @@ Pipeline::Pipeline(const glm::ivec2& resolution) : lithium::RenderPipeline{resol
 
     _screenShader = std::make_shared<lithium::ShaderProgram>(
         std::shared_ptr<lithium::VertexShader>(lithium::VertexShader::fromSource(vertSrc)),
-        std::shared_ptr<lithium::FragmentShader>(lithium::FragmentShader::fromSource(fragSrc)));
+        std::shared_ptr<lithium::FragmentShader>(lithium::FragmentShader::fromSource(screenFragSrc.c_str())));
 
     _screenMesh = std::shared_ptr<lithium::Mesh>(lithium::Plane2D());
 
@@ -202,16 +199,47 @@ Pipeline::Pipeline(const glm::ivec2& resolution) : lithium::RenderPipeline{resol
 
     clearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
+    _upscaleShader = std::make_shared<lithium::ShaderProgram>(
+        std::shared_ptr<lithium::VertexShader>(lithium::VertexShader::fromSource(upscaleVertSrc)),
+        std::shared_ptr<lithium::FragmentShader>(lithium::FragmentShader::fromSource(upscaleFragSrc)));
+    _upscaleShader->setUniform("u_scene", 0);
+    glGenVertexArrays(1, &_upscaleVertexArray);
+
+    _sceneTarget = std::make_shared<RenderTarget>();
+    _gpuTimer = std::make_shared<GpuTimer>();
+
     _mainStage = addRenderStage(std::make_shared<lithium::RenderStage>(nullptr, [this](){
         static const GLuint viewOffset{static_cast<GLuint>(sizeof(glm::mat4))};
         static const GLuint eyePosOffset{static_cast<GLuint>(sizeof(glm::mat4) * 2)};
 
+        PROFILE_ZONE("main stage");
+        float gpuMs = _gpuTimer->poll();
+        if(gpuMs > 0.0f)
+        {
+            _resolutionController.update(gpuMs);
+        }
+        _sceneTarget->resize(internalResolution());
+
+        _gpuTimer->begin();
+        // The screen shader runs at the internal resolution, which the
+        // terrain and bin passes follow through internalResolution().
+        _sceneTarget->bind();
         clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         disableDepthWriting();
-        _screenShader->setUniform("u_resolution", glm::vec2(this->resolution()));
-        _screenShader->setUniform("u_time", time());
         _screenGroup->render(_screenShader.get());
+        _sceneTarget->unbind();
+
+        // Final upscale to the window.
+        clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glUseProgram(_upscaleShader->id());
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, _sceneTarget->texture());
+        glBindVertexArray(_upscaleVertexArray);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D, 0);
         enableDepthWriting();
+        _gpuTimer->end();
     }));
 
 }
@@ -223,6 +251,10 @@ void Pipeline::setResolution(const glm::ivec2& resolution)
 
 Pipeline::~Pipeline() noexcept
 {
+    glDeleteVertexArrays(1, &_upscaleVertexArray);
+    _upscaleShader = nullptr;
+    _sceneTarget = nullptr;
+    _gpuTimer = nullptr;
     _screenShader = nullptr;
     _screenMesh = nullptr;
 }
\ No newline at end of file
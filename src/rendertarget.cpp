@@ -0,0 +1,49 @@
+#include "rendertarget.h"
+
+RenderTarget::RenderTarget()
+{
+    glGenFramebuffers(1, &_framebuffer);
+    glGenTextures(1, &_texture);
+}
+
+RenderTarget::~RenderTarget() noexcept
+{
+    glDeleteTextures(1, &_texture);
+    glDeleteFramebuffers(1, &_framebuffer);
+}
+
+void RenderTarget::resize(const glm::ivec2& size)
+{
+    if(size == _size)
+    {
+        return;
+    }
+    _size = size;
+    glBindTexture(GL_TEXTURE_2D, _texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLint previous{0};
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, previous);
+}
+
+void RenderTarget::bind()
+{
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_previousFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, _previousViewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+    glViewport(0, 0, _size.x, _size.y);
+}
+
+void RenderTarget::unbind()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, _previousFramebuffer);
+    glViewport(_previousViewport[0], _previousViewport[1], _previousViewport[2], _previousViewport[3]);
+}
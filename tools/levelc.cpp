@@ -0,0 +1,57 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "levelfile.h"
+#include "levelimage.h"
+#include "spawntable.h"
+
+/*
+ * Compiles a level image into the chunked LevelFile format. Only the first row
+ * is used, like the game does with level.png, and the image width is spread
+ * over the same four world units.
+ */
+int main(int argc, const char* argv[])
+{
+    if(argc < 3)
+    {
+        fprintf(stderr, "usage: %s <level.png> <level.sjl> [columnsPerUnit]\n", argv[0]);
+        return 1;
+    }
+
+    // With the edits the game has not saved into the image yet.
+    LevelImage image;
+    if(!image.load(argv[1]))
+    {
+        fprintf(stderr, "failed to load %s\n", argv[1]);
+        return 1;
+    }
+    int width = image.width();
+
+    float columnsPerUnit = argc > 3 ? static_cast<float>(atof(argv[3])) : width / 4.0f;
+    if(!std::isfinite(columnsPerUnit) || columnsPerUnit <= 0.0f)
+    {
+        fprintf(stderr, "columnsPerUnit must be a positive number\n");
+        return 1;
+    }
+    bool ok = LevelFile::write(argv[2], image.bytes(), width, columnsPerUnit);
+    if(!ok)
+    {
+        fprintf(stderr, "failed to write %s\n", argv[2]);
+        return 1;
+    }
+    printf("%s: %d columns, %.1f per unit\n", argv[2], width, columnsPerUnit);
+
+    // The entities go along with the level.
+    SpawnTable spawns;
+    if(spawns.open(SpawnTable::tablePath(argv[1])))
+    {
+        std::string spawnPath = SpawnTable::tablePath(argv[2]);
+        if(!SpawnTable::write(spawnPath, spawns.entries(), spawns.size()))
+        {
+            fprintf(stderr, "failed to write %s\n", spawnPath.c_str());
+            return 1;
+        }
+        printf("%s: %zu spawns\n", spawnPath.c_str(), spawns.size());
+    }
+    return 0;
+}
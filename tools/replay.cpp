@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include "gameworld.h"
+#include "inputlog.h"
+#include "levelfile.h"
+#include "levelimage.h"
+#include "spawntable.h"
+
+/*
+ * Replays a session recorded with --record as fast as the simulation runs and
+ * checks the final state hash. Exits nonzero on a mismatch, so recorded
+ * sessions can gate changes in CI.
+ */
+int main(int argc, const char* argv[])
+{
+    if(argc < 2)
+    {
+        fprintf(stderr, "usage: %s <session.sjr> [level]\n", argv[0]);
+        return 2;
+    }
+
+    InputLog log;
+    if(!log.load(argv[1]))
+    {
+        if(log.header().magic == InputLog::Magic && log.header().version != InputLog::Version)
+        {
+            fprintf(stderr, "%s is a version %u log and this build replays version %u; record it again\n", argv[1],
+                log.header().version, InputLog::Version);
+        }
+        else
+        {
+            fprintf(stderr, "failed to load %s\n", argv[1]);
+        }
+        return 2;
+    }
+    const InputLog::Header& header = log.header();
+    std::string levelPath = argc > 2 ? argv[2] : log.levelPath();
+
+    GameWorld world;
+    LevelFile level;
+    LevelImage image;
+    size_t columns{0};
+    if(level.open(levelPath))
+    {
+        columns = level.columnCount();
+        world.setMap(level.columns(), columns, level.columnsPerUnit());
+    }
+    else
+    {
+        // With the edits the game has not saved into the image yet.
+        if(!image.load(levelPath))
+        {
+            fprintf(stderr, "failed to load level %s\n", levelPath.c_str());
+            return 2;
+        }
+        columns = image.width();
+        world.setMap(image.bytes(), columns, header.columnsPerUnit);
+    }
+
+    uint64_t mapHash = InputLog::hashMap(world.mapBytes(), columns * GameWorld::MapStride);
+    if(columns != header.mapColumns || mapHash != header.mapHash)
+    {
+        fprintf(stderr, "%s does not match the recorded level\n", levelPath.c_str());
+        return 2;
+    }
+
+    SpawnTable spawns;
+    bool hasSpawns = spawns.open(SpawnTable::tablePath(levelPath));
+    if(InputLog::hashSpawns(hasSpawns ? &spawns : nullptr) != header.spawnHash)
+    {
+        fprintf(stderr, "%s does not match the recorded spawn table\n", SpawnTable::tablePath(levelPath).c_str());
+        return 2;
+    }
+    if(hasSpawns)
+    {
+        world.setSpawns(&spawns);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t hash = log.replay(world);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double ticksPerSecond = header.tickCount / std::max(elapsed, 1e-9);
+    printf("%llu ticks (%zu runs) in %.3f s: %.0f ticks/s, %.0fx real time\n",
+        static_cast<unsigned long long>(header.tickCount), log.runs().size(), elapsed, ticksPerSecond,
+        ticksPerSecond * GameWorld::FixedTimestep);
+    if(hash != header.finalHash)
+    {
+        printf("state hash mismatch: recorded %016llx, replayed %016llx\n",
+            static_cast<unsigned long long>(header.finalHash), static_cast<unsigned long long>(hash));
+        return 1;
+    }
+    printf("state hash %016llx matches\n", static_cast<unsigned long long>(hash));
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include <cstdio>
+#include <vector>
+#include "spawntable.h"
+
+/*
+ * Compiles a text list of spawns into a level's spawn table. Each line is a
+ * type and a position in world units, like "enemy 5.0 0.0" or
+ * "collectable 1.2 0.08"; blank lines and lines starting with # are skipped.
+ */
+int main(int argc, const char* argv[])
+{
+    if(argc < 3)
+    {
+        fprintf(stderr, "usage: %s <spawns.txt> <level.spawns>\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<SpawnTable::Spawn> spawns;
+    int line{0};
+    if(!SpawnTable::parse(argv[1], spawns, line))
+    {
+        if(line == 0)
+        {
+            fprintf(stderr, "failed to open %s\n", argv[1]);
+        }
+        else
+        {
+            fprintf(stderr, "%s:%d: expected \"collectable x y\" or \"enemy x y\"\n", argv[1], line);
+        }
+        return 1;
+    }
+
+    if(!SpawnTable::write(argv[2], spawns))
+    {
+        fprintf(stderr, "failed to write %s\n", argv[2]);
+        return 1;
+    }
+    printf("%s: %zu spawns\n", argv[2], spawns.size());
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "batchrunner.h"
+#include "levelfile.h"
+#include "levelimage.h"
+#include "spawntable.h"
+
+/*
+ * Plays a level headless with many bots at once and reports how many reach
+ * the end. Exits nonzero when fewer than --min-completion of them do, so
+ * edited levels can be checked in CI before anyone plays them. Without the
+ * option the scripted runner must finish nine runs in ten and random bots
+ * one in ten; a level that passes nobody fails either way.
+ */
+int main(int argc, const char* argv[])
+{
+    if(argc < 2)
+    {
+        fprintf(stderr, "usage: %s <level> [--instances n] [--threads n] [--seconds s] [--random] [--min-completion f]\n", argv[0]);
+        return 2;
+    }
+
+    BatchRunner::Config config;
+    unsigned threads{0};
+    double minCompletion{-1.0};
+    for(int i = 2; i < argc; ++i)
+    {
+        bool hasValue = i + 1 < argc;
+        if(strcmp(argv[i], "--random") == 0)
+        {
+            config.bot = BatchRunner::Bot::RANDOM;
+        }
+        else if(hasValue && strcmp(argv[i], "--instances") == 0)
+        {
+            config.instances = atoi(argv[++i]);
+        }
+        else if(hasValue && strcmp(argv[i], "--threads") == 0)
+        {
+            threads = static_cast<unsigned>(atoi(argv[++i]));
+        }
+        else if(hasValue && strcmp(argv[i], "--seconds") == 0)
+        {
+            config.maxTicks = static_cast<unsigned long long>(atof(argv[++i]) / GameWorld::FixedTimestep);
+        }
+        else if(hasValue && strcmp(argv[i], "--min-completion") == 0)
+        {
+            minCompletion = atof(argv[++i]);
+        }
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    std::string levelPath = argv[1];
+    LevelFile level;
+    LevelImage image;
+    const unsigned char* map{nullptr};
+    size_t columns{0};
+    float columnsPerUnit{0.0f};
+    if(level.open(levelPath))
+    {
+        map = level.columns();
+        columns = level.columnCount();
+        columnsPerUnit = level.columnsPerUnit();
+    }
+    else
+    {
+        // With the edits the game has not saved into the image yet.
+        if(!image.load(levelPath))
+        {
+            fprintf(stderr, "failed to load level %s\n", levelPath.c_str());
+            return 2;
+        }
+        map = image.bytes();
+        columns = image.width();
+    }
+
+    SpawnTable spawns;
+    if(spawns.open(SpawnTable::tablePath(levelPath)))
+    {
+        config.spawns = &spawns;
+    }
+
+    if(minCompletion < 0.0)
+    {
+        minCompletion = config.bot == BatchRunner::Bot::RUNNER ? 0.9 : 0.1;
+    }
+
+    BatchRunner runner{threads ? std::make_shared<ThreadPool>(threads) : nullptr};
+    BatchRunner::Report report = runner.run(map, columns, columnsPerUnit, config);
+
+    double completion = report.instances ? static_cast<double>(report.completed) / report.instances : 0.0;
+    printf("%d %s bots: %d completed (%.1f%%), %.2f water hits and %.2f enemy hits per run, %.2f collected\n",
+        report.instances, config.bot == BatchRunner::Bot::RUNNER ? "runner" : "random", report.completed,
+        completion * 100.0, static_cast<double>(report.waterHits) / std::max(report.instances, 1),
+        static_cast<double>(report.enemyHits) / std::max(report.instances, 1),
+        static_cast<double>(report.collected) / std::max(report.instances, 1));
+    printf("%llu ticks in %.2f s on %u threads: %.0f ticks/s, %.0f ticks/s per thread\n",
+        report.ticks, report.seconds, report.threads, report.ticksPerSecond(), report.ticksPerSecondPerThread());
+    if(completion < minCompletion)
+    {
+        fprintf(stderr, "completion %.1f%% is below the required %.1f%%\n", completion * 100.0, minCompletion * 100.0);
+        return 1;
+    }
+    return 0;
+}